@@ -0,0 +1,28 @@
+# Writes OUTPUT from git_sha.h.in with the current commit of SOURCE_DIR,
+# suffixed -dirty when tracked files differ from it. Run on every build by
+# the hashmap_bench_git_sha target; configure_file leaves OUTPUT untouched
+# while the value is unchanged, so nothing recompiles needlessly.
+execute_process(
+    COMMAND git rev-parse --short=12 HEAD
+    WORKING_DIRECTORY ${SOURCE_DIR}
+    OUTPUT_VARIABLE HASHMAP_BENCH_GIT_SHA
+    OUTPUT_STRIP_TRAILING_WHITESPACE
+    RESULT_VARIABLE GIT_RESULT
+    ERROR_QUIET
+)
+if(NOT GIT_RESULT EQUAL 0 OR NOT HASHMAP_BENCH_GIT_SHA)
+    set(HASHMAP_BENCH_GIT_SHA "unknown")
+else()
+    execute_process(
+        COMMAND git status --porcelain --untracked-files=no
+        WORKING_DIRECTORY ${SOURCE_DIR}
+        OUTPUT_VARIABLE GIT_CHANGES
+        OUTPUT_STRIP_TRAILING_WHITESPACE
+        ERROR_QUIET
+    )
+    if(GIT_CHANGES)
+        string(APPEND HASHMAP_BENCH_GIT_SHA "-dirty")
+    endif()
+endif()
+
+configure_file(${CMAKE_CURRENT_LIST_DIR}/git_sha.h.in ${OUTPUT} @ONLY)
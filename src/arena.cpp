@@ -0,0 +1,49 @@
+#include "arena.hpp"
+
+namespace hashmap_bench {
+
+void SlabPoolResource::release() {
+    for (void* slab : slabs_) {
+        upstream_->deallocate(slab, kSlabBytes, kGranule);
+    }
+    slabs_.clear();
+    for (size_t i = 0; i < kClasses; i++) {
+        free_[i] = nullptr;
+        cursor_[i] = nullptr;
+        limit_[i] = nullptr;
+    }
+}
+
+void* SlabPoolResource::do_allocate(size_t bytes, size_t alignment) {
+    if (bytes > kMaxBlock || alignment > kGranule) {
+        return upstream_->allocate(bytes, alignment);
+    }
+    size_t cls = bytes == 0 ? 0 : (bytes - 1) / kGranule;
+    if (FreeBlock* block = free_[cls]) {
+        free_[cls] = block->next;
+        return block;
+    }
+    size_t block_size = (cls + 1) * kGranule;
+    if (cursor_[cls] == limit_[cls]) {
+        char* slab = static_cast<char*>(upstream_->allocate(kSlabBytes, kGranule));
+        slabs_.push_back(slab);
+        cursor_[cls] = slab;
+        limit_[cls] = slab + kSlabBytes / block_size * block_size;
+    }
+    void* ptr = cursor_[cls];
+    cursor_[cls] += block_size;
+    return ptr;
+}
+
+void SlabPoolResource::do_deallocate(void* ptr, size_t bytes, size_t alignment) {
+    if (bytes > kMaxBlock || alignment > kGranule) {
+        upstream_->deallocate(ptr, bytes, alignment);
+        return;
+    }
+    size_t cls = bytes == 0 ? 0 : (bytes - 1) / kGranule;
+    FreeBlock* block = static_cast<FreeBlock*>(ptr);
+    block->next = free_[cls];
+    free_[cls] = block;
+}
+
+} // namespace hashmap_bench
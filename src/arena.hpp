@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+namespace hashmap_bench {
+
+// Arena-backed node containers: the per-entry allocations of node-based maps
+// come from a memory resource owned by the map instead of one malloc each.
+
+// Fixed-size slab pool. Requests of up to kMaxBlock bytes are rounded up to a
+// 16-byte size class and carved from 64 KiB slabs; freed blocks go on their
+// class's free list and are reused. Larger requests (bucket and slot arrays)
+// go upstream. Slabs are returned only by release() or the destructor.
+class SlabPoolResource : public std::pmr::memory_resource {
+public:
+    explicit SlabPoolResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream_(upstream) {}
+    ~SlabPoolResource() override { release(); }
+    SlabPoolResource(const SlabPoolResource&) = delete;
+    SlabPoolResource& operator=(const SlabPoolResource&) = delete;
+
+    // Return every slab upstream; blocks handed out before become invalid
+    void release();
+
+    size_t slab_count() const { return slabs_.size(); }
+
+    static constexpr size_t kGranule = 16;
+    static constexpr size_t kMaxBlock = 256;
+    static constexpr size_t kSlabBytes = 64 * 1024;
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+private:
+    static constexpr size_t kClasses = kMaxBlock / kGranule;
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    std::pmr::memory_resource* upstream_;
+    FreeBlock* free_[kClasses] = {};
+    char* cursor_[kClasses] = {};
+    char* limit_[kClasses] = {};
+    std::vector<void*> slabs_;
+};
+
+// A pmr container together with the resource it allocates from. The resource
+// lives on the heap so the pair can be moved out of create(), and is declared
+// first so the container is destroyed before it.
+template <typename Container, typename Resource>
+struct ArenaMap {
+    std::unique_ptr<Resource> arena = std::make_unique<Resource>();
+    Container map{arena.get()};
+};
+
+} // namespace hashmap_bench
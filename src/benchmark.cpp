@@ -1,115 +1,515 @@
 #include "benchmark.hpp"
 #include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+#include "key_corpus.hpp"
 
 namespace hashmap_bench {
 
 uint64_t side_effect = 0;
 
-void generate_short_keys(std::vector<std::string>& keys, int num_power) {
+namespace {
+
+// Keys per generator thread below which another thread costs more than it saves
+constexpr uint64_t kMinKeysPerThread = uint64_t{1} << 14;
+
+// Run fill(begin, end) over [0, num) in contiguous ranges, one per CPU this
+// process may run on. Every generator computes key i from i alone, so the
+// ranges are independent and the output matches a single pass.
+template <typename Fill>
+void parallel_fill(uint64_t num, Fill fill) {
+    uint64_t threads = std::min<uint64_t>(available_cpus().size(), num / kMinKeysPerThread);
+    if (threads <= 1) {
+        fill(uint64_t{0}, num);
+        return;
+    }
+    uint64_t chunk = (num + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    for (uint64_t begin = chunk; begin < num; begin += chunk) {
+        workers.emplace_back(fill, begin, std::min(begin + chunk, num));
+    }
+    fill(uint64_t{0}, chunk);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+// short, mid and long keys: a 6-character group repeated every 8 bytes
+// ("!!!!!!--" for mid and long). Characters 0 and 1 count the key index mod
+// 64 and 64^2; characters 2..5 hold the index >> 12 in base 64.
+void generate_counter_keys(std::vector<std::string>& keys, int num_power, size_t groups) {
     uint64_t num = 1ULL << num_power;
     keys.clear();
-    keys.reserve(num);
+    keys.resize(num);
     
-    int i_bound = 1 << (num_power - 12);
-    std::string uuid = "!!!!!!";
-    uint64_t counter = 0;
-    
-    for (int i = 0; i < i_bound; i++) {
-        for (int j = 2, val = counter >> 12; j < 6; j++, val >>= 6) {
-            uuid[j] = 0x21 + (val & 0x3F);
-        }
-        for (int j = 0; j < 64; j++) {
-            uuid[1] = 0x21 + j;
-            for (int k = 0; k < 64; k++) {
-                uuid[0] = 0x21 + k;
-                counter++;
-                keys.push_back(uuid);
+    size_t length = groups == 1 ? 6 : groups * 8;
+    parallel_fill(num, [&keys, groups, length](uint64_t begin, uint64_t end) {
+        std::string uuid(length, '-');
+        for (uint64_t i = begin; i < end; i++) {
+            char group[6];
+            group[0] = static_cast<char>(0x21 + (i & 0x3F));
+            group[1] = static_cast<char>(0x21 + ((i >> 6) & 0x3F));
+            for (int j = 2; j < 6; j++) {
+                group[j] = static_cast<char>(0x21 + ((i >> (12 + 6 * (j - 2))) & 0x3F));
+            }
+            for (size_t g = 0; g < groups; g++) {
+                memcpy(&uuid[g * 8], group, sizeof(group));
             }
+            keys[i] = uuid;
         }
-    }
+    });
+}
+
+} // namespace
+
+void generate_short_keys(std::vector<std::string>& keys, int num_power) {
+    generate_counter_keys(keys, num_power, 1);
 }
 
 void generate_mid_keys(std::vector<std::string>& keys, int num_power) {
+    generate_counter_keys(keys, num_power, 4);
+}
+
+void generate_long_keys(std::vector<std::string>& keys, int num_power) {
+    generate_counter_keys(keys, num_power, 32);
+}
+
+void generate_int_keys(std::vector<uint64_t>& keys, int num_power) {
     uint64_t num = 1ULL << num_power;
     keys.clear();
     keys.reserve(num);
     
-    int i_bound = 1 << (num_power - 12);
-    std::string uuid = "!!!!!!--!!!!!!--!!!!!!--!!!!!!--";
-    uint64_t counter = 0;
-    
-    for (int i = 0; i < i_bound; i++) {
-        for (int j = 2, val = counter >> 12; j < 6; j++, val >>= 6) {
-            uuid[j] = 0x21 + (val & 0x3F);
-            uuid[j + 8] = 0x21 + (val & 0x3F);
-            uuid[j + 16] = 0x21 + (val & 0x3F);
-            uuid[j + 24] = 0x21 + (val & 0x3F);
+    for (uint64_t i = 0; i < num; i++) {
+        keys.push_back(i);
+    }
+}
+
+bool parse_key_spec(const std::string& key_type, KeySpec& spec) {
+    if (key_type.rfind("str:", 0) != 0) {
+        return false;
+    }
+    std::string lengths = key_type.substr(4);
+    size_t dash = lengths.find('-');
+    char* end = nullptr;
+    long first = strtol(lengths.c_str(), &end, 10);
+    long last = first;
+    if (dash != std::string::npos) {
+        if (end != lengths.c_str() + dash) {
+            return false;
+        }
+        last = strtol(lengths.c_str() + dash + 1, &end, 10);
+    }
+    if (lengths.empty() || *end != '\0' || first < 1 || last < first) {
+        return false;
+    }
+    spec.min_len = static_cast<size_t>(first);
+    spec.max_len = static_cast<size_t>(last);
+    return true;
+}
+
+bool parse_key_alphabet(const std::string& text, std::string& alphabet) {
+    std::string chars;
+    if (text == "alnum") {
+        chars = kAlnumAlphabet;
+    } else if (text == "hex") {
+        chars = "0123456789abcdef";
+    } else if (text == "digits") {
+        chars = "0123456789";
+    } else if (text == "printable") {
+        for (char c = 0x21; c < 0x7f; c++) {
+            chars += c;
         }
-        for (int j = 0; j < 64; j++) {
-            uuid[1] = 0x21 + j;
-            uuid[1 + 8] = 0x21 + j;
-            uuid[1 + 16] = 0x21 + j;
-            uuid[1 + 24] = 0x21 + j;
-            for (int k = 0; k < 64; k++) {
-                uuid[0] = 0x21 + k;
-                uuid[0 + 8] = 0x21 + k;
-                uuid[0 + 16] = 0x21 + k;
-                uuid[0 + 24] = 0x21 + k;
-                counter++;
-                keys.push_back(uuid);
+    } else {
+        for (char c : text) {
+            if (static_cast<unsigned char>(c) >= 0x80) {
+                return false;
+            }
+            if (chars.find(c) == std::string::npos) {
+                chars += c;
             }
         }
     }
+    if (chars.size() < 2) {
+        return false;
+    }
+    alphabet = chars;
+    return true;
 }
 
-void generate_long_keys(std::vector<std::string>& keys, int num_power) {
+size_t min_key_length(const KeySpec& spec, uint64_t n) {
+    size_t digits = 1;
+    for (uint64_t reach = spec.alphabet.size(); reach < n; reach *= spec.alphabet.size()) {
+        digits++;
+    }
+    return spec.prefix_len + digits;
+}
+
+void generate_string_keys(std::vector<std::string>& keys, int num_power, const KeySpec& spec, uint64_t seed) {
     uint64_t num = 1ULL << num_power;
     keys.clear();
-    keys.reserve(num);
+    keys.resize(num);
     
-    int i_bound = 1 << (num_power - 12);
-    std::string uuid =
-        "!!!!!!--!!!!!!--!!!!!!--!!!!!!--"
-        "!!!!!!--!!!!!!--!!!!!!--!!!!!!--"
-        "!!!!!!--!!!!!!--!!!!!!--!!!!!!--"
-        "!!!!!!--!!!!!!--!!!!!!--!!!!!!--"
-        "!!!!!!--!!!!!!--!!!!!!--!!!!!!--"
-        "!!!!!!--!!!!!!--!!!!!!--!!!!!!--"
-        "!!!!!!--!!!!!!--!!!!!!--!!!!!!--"
-        "!!!!!!--!!!!!!--!!!!!!--!!!!!!--";
-    uint64_t counter = 0;
-    
-    for (int i = 0; i < i_bound; i++) {
-        for (int j = 2, val = counter >> 12; j < 6; j++, val >>= 6) {
-            for (int k = 0; k < 256; k += 8) {
-                uuid[j + k] = 0x21 + (val & 0x3F);
-            }
-        }
-        for (int j = 0; j < 64; j++) {
-            for (int h = 0; h < 256; h += 8) {
-                uuid[h + 1] = 0x21 + j;
-            }
-            for (int k = 0; k < 64; k++) {
-                for (int h = 0; h < 256; h += 8) {
-                    uuid[h] = 0x21 + k;
+    const std::string& alphabet = spec.alphabet;
+    size_t base = alphabet.size();
+    size_t digits = min_key_length(spec, num) - spec.prefix_len;
+    size_t span = spec.max_len - spec.min_len + 1;
+    std::string prefix;
+    for (size_t p = 0; p < spec.prefix_len; p++) {
+        prefix += alphabet[p % base];
+    }
+    
+    parallel_fill(num, [&](uint64_t begin, uint64_t end) {
+        for (uint64_t i = begin; i < end; i++) {
+            // Length and filler depend only on (seed, i)
+            uint64_t bits = tomas_wang_int64_hash(i ^ (seed * 0x9E3779B97F4A7C15ULL));
+            size_t len = spec.min_len + static_cast<size_t>(bits % span);
+            std::string& key = keys[i];
+            key = prefix;
+            key.resize(len);
+            size_t suffix = len - digits;
+            for (size_t p = spec.prefix_len; p < suffix; p++) {
+                if ((p - spec.prefix_len) % 8 == 0) {
+                    bits = tomas_wang_int64_hash(bits + p);
                 }
-                counter++;
-                keys.push_back(uuid);
+                key[p] = alphabet[bits % base];
+                bits /= base;
+            }
+            uint64_t index = i;
+            for (size_t p = len; p > suffix; p--) {
+                key[p - 1] = alphabet[index % base];
+                index /= base;
             }
         }
+    });
+}
+
+void generate_miss_keys(const std::vector<std::string>& keys, std::vector<std::string>& misses) {
+    std::vector<std::string_view> sorted(keys.begin(), keys.end());
+    std::sort(sorted.begin(), sorted.end());
+    auto usable = [&sorted](std::string_view miss) {
+        return !is_reserved_key(miss) && !std::binary_search(sorted.begin(), sorted.end(), miss);
+    };
+    
+    misses.clear();
+    misses.reserve(keys.size());
+    for (const auto& key : keys) {
+        // Flip one bit, high bits before low ones and the first byte first,
+        // so ASCII keys keep their length and usually take the first try;
+        // append bytes once every single-bit flip is a key
+        std::string miss = key;
+        bool found = false;
+        for (int bit = 7; bit >= 0 && !found; bit--) {
+            for (size_t i = 0; i < miss.size() && !found; i++) {
+                miss[i] = static_cast<char>(miss[i] ^ (1 << bit));
+                found = usable(miss);
+                if (!found) {
+                    miss[i] = static_cast<char>(miss[i] ^ (1 << bit));
+                }
+            }
+        }
+        while (!found) {
+            miss.push_back('\x80');
+            found = usable(miss);
+        }
+        misses.push_back(std::move(miss));
     }
 }
 
-void generate_int_keys(std::vector<uint64_t>& keys, int num_power) {
-    uint64_t num = 1ULL << num_power;
-    keys.clear();
-    keys.reserve(num);
+template <typename Keys>
+static void pack_keys(const Keys& keys, size_t n, std::string& data, std::vector<size_t>& offsets) {
+    size_t total = 0;
+    for (size_t i = 0; i < n; i++) {
+        total += keys[i].size();
+    }
+    data.reserve(total);
+    offsets.reserve(n + 1);
+    for (size_t i = 0; i < n; i++) {
+        data += keys[i];
+        offsets.push_back(data.size());
+    }
+}
+
+void KeyStore::assign(const std::vector<std::string>& keys) {
+    clear();
+    pack_keys(keys, keys.size(), data_, offsets_);
+}
+
+void KeyStore::assign(const std::string_view* keys, size_t n) {
+    clear();
+    pack_keys(keys, n, data_, offsets_);
+}
+
+void generate_miss_keys(const std::vector<uint64_t>& keys, std::vector<uint64_t>& misses) {
+    std::vector<uint64_t> sorted(keys);
+    std::sort(sorted.begin(), sorted.end());
     
-    for (uint64_t i = 0; i < num; i++) {
-        keys.push_back(i);
+    // Count up from the largest key, wrapping past ~0, and skip every value
+    // that is a key or a dense/sparse_hash_map marker
+    uint64_t next = sorted.empty() ? 0 : sorted.back() + 1;
+    misses.clear();
+    misses.reserve(keys.size());
+    while (misses.size() < keys.size()) {
+        if (!is_reserved_key(next) && !std::binary_search(sorted.begin(), sorted.end(), next)) {
+            misses.push_back(next);
+        }
+        next++;
+    }
+}
+
+// Parse "A[:B]" parameters following a distribution name
+static bool parse_params(const std::string& params, double* out, size_t max_fields, size_t& n) {
+    std::stringstream ss(params);
+    std::string field;
+    n = 0;
+    while (std::getline(ss, field, ':')) {
+        if (n == max_fields || field.empty()) {
+            return false;
+        }
+        char* end = nullptr;
+        double value = strtod(field.c_str(), &end);
+        if (*end != '\0' || value <= 0) {
+            return false;
+        }
+        out[n++] = value;
+    }
+    return true;
+}
+
+bool parse_access_distribution(const std::string& spec, AccessDistribution& dist) {
+    dist = AccessDistribution{};
+    size_t colon = spec.find(':');
+    std::string name = spec.substr(0, colon);
+    std::string params = colon == std::string::npos ? "" : spec.substr(colon + 1);
+    double values[2];
+    size_t n = 0;
+    if (colon != std::string::npos && !parse_params(params, values, 2, n)) {
+        return false;
     }
+    
+    if (name == "seq" || name == "sequential") {
+        dist.pattern = AccessPattern::Sequential;
+        return n == 0;
+    } else if (name == "uniform") {
+        dist.pattern = AccessPattern::Uniform;
+        return n == 0;
+    } else if (name == "zipf" || name == "zipfian" || name == "latest") {
+        dist.pattern = name == "latest" ? AccessPattern::Latest : AccessPattern::Zipfian;
+        if (n == 1) {
+            dist.theta = values[0];
+        }
+        return n <= 1 && dist.theta < 1.0;
+    } else if (name == "hotset") {
+        dist.pattern = AccessPattern::HotSet;
+        if (n == 2) {
+            // Percentages when either value exceeds 1 (hotset:90:10)
+            double scale = values[0] > 1 || values[1] > 1 ? 0.01 : 1.0;
+            dist.hot_op_fraction = values[0] * scale;
+            dist.hot_key_fraction = values[1] * scale;
+        }
+        return (n == 0 || n == 2) && dist.hot_op_fraction <= 1.0 && dist.hot_key_fraction <= 1.0;
+    }
+    return false;
+}
+
+std::string describe_access_distribution(const AccessDistribution& dist) {
+    std::ostringstream out;
+    switch (dist.pattern) {
+        case AccessPattern::Sequential: out << "sequential"; break;
+        case AccessPattern::Uniform: out << "uniform"; break;
+        case AccessPattern::Zipfian: out << "zipf (theta=" << dist.theta << ")"; break;
+        case AccessPattern::Latest: out << "latest (theta=" << dist.theta << ")"; break;
+        case AccessPattern::HotSet:
+            out << "hotset (" << dist.hot_op_fraction * 100 << "% of ops -> "
+                << dist.hot_key_fraction * 100 << "% of keys)";
+            break;
+    }
+    return out.str();
+}
+
+// Zipfian rank generator from Gray et al., "Quickly Generating Billion-Record
+// Synthetic Databases" (the one YCSB uses); rank 0 is the most popular
+class ZipfianGenerator {
+public:
+    ZipfianGenerator(size_t n, double theta)
+        : n_(n), alpha_(1.0 / (1.0 - theta)), zeta2_(1.0 + std::pow(0.5, theta)) {
+        zetan_ = 0;
+        for (size_t i = 1; i <= n; i++) {
+            zetan_ += 1.0 / std::pow(static_cast<double>(i), theta);
+        }
+        eta_ = (1.0 - std::pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta2_ / zetan_);
+    }
+    
+    template <typename Rng>
+    size_t next(Rng& rng) {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        double uz = u * zetan_;
+        if (uz < 1.0) {
+            return 0;
+        }
+        if (uz < zeta2_) {
+            return std::min<size_t>(1, n_ - 1);
+        }
+        size_t rank = static_cast<size_t>(n_ * std::pow(eta_ * u - eta_ + 1.0, alpha_));
+        return std::min(rank, n_ - 1);
+    }
+
+private:
+    size_t n_;
+    double alpha_;
+    double zeta2_;
+    double zetan_;
+    double eta_;
+};
+
+void generate_access_indices(std::vector<uint32_t>& indices, size_t num_keys, size_t num_ops,
+                             const AccessDistribution& dist, uint64_t seed) {
+    indices.clear();
+    if (dist.pattern == AccessPattern::Sequential || num_keys == 0) {
+        return;
+    }
+    indices.reserve(num_ops);
+    std::mt19937_64 rng(seed);
+    
+    // Scatter popularity ranks so hot keys are spread across the table
+    std::vector<uint32_t> permutation;
+    if (dist.pattern == AccessPattern::Zipfian || dist.pattern == AccessPattern::HotSet) {
+        permutation.resize(num_keys);
+        std::iota(permutation.begin(), permutation.end(), 0);
+        std::shuffle(permutation.begin(), permutation.end(), rng);
+    }
+    
+    switch (dist.pattern) {
+        case AccessPattern::Uniform: {
+            std::uniform_int_distribution<size_t> pick(0, num_keys - 1);
+            for (size_t i = 0; i < num_ops; i++) {
+                indices.push_back(static_cast<uint32_t>(pick(rng)));
+            }
+            break;
+        }
+        case AccessPattern::Zipfian:
+        case AccessPattern::Latest: {
+            ZipfianGenerator zipf(num_keys, dist.theta);
+            for (size_t i = 0; i < num_ops; i++) {
+                size_t rank = zipf.next(rng);
+                indices.push_back(dist.pattern == AccessPattern::Latest
+                                      ? static_cast<uint32_t>(num_keys - 1 - rank)
+                                      : permutation[rank]);
+            }
+            break;
+        }
+        case AccessPattern::HotSet: {
+            size_t hot = std::clamp<size_t>(
+                static_cast<size_t>(num_keys * dist.hot_key_fraction), 1, num_keys);
+            std::bernoulli_distribution hit_hot(dist.hot_op_fraction);
+            std::uniform_int_distribution<size_t> pick_hot(0, hot - 1);
+            std::uniform_int_distribution<size_t> pick_cold(hot, num_keys - 1);
+            for (size_t i = 0; i < num_ops; i++) {
+                bool use_hot = hot == num_keys || hit_hot(rng);
+                indices.push_back(permutation[use_hot ? pick_hot(rng) : pick_cold(rng)]);
+            }
+            break;
+        }
+        case AccessPattern::Sequential:
+            break;
+    }
+}
+
+bool Clock::has_invariant_tsc() {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 || eax < 0x80000007) {
+        return false;
+    }
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return (edx & (1u << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+static uint64_t monotonic_raw_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+void Clock::init(ClockSource preferred) {
+    source_ = ClockSource::SteadyClock;
+    ns_per_tick_ = 1.0;
+    
+    if (preferred == ClockSource::Tsc && has_invariant_tsc()) {
+        // Spin for ~20ms and take the TSC rate from the raw monotonic clock
+        uint64_t ns_start = monotonic_raw_ns();
+        uint64_t tsc_start = read_cycle_counter();
+        uint64_t ns_end;
+        do {
+            ns_end = monotonic_raw_ns();
+        } while (ns_end - ns_start < 20000000ULL);
+        uint64_t tsc_end = read_cycle_counter();
+        
+        if (tsc_end > tsc_start) {
+            source_ = ClockSource::Tsc;
+            ns_per_tick_ = static_cast<double>(ns_end - ns_start) / static_cast<double>(tsc_end - tsc_start);
+        }
+    }
+    
+    overhead_ticks_ = measure_overhead();
+}
+
+uint64_t Clock::measure_overhead() {
+    // Median of back-to-back reads
+    std::vector<uint64_t> samples(1001);
+    for (auto& sample : samples) {
+        uint64_t start = now();
+        sample = now() - start;
+    }
+    std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+    return samples[samples.size() / 2];
+}
+
+const char* Clock::source_name() {
+    return source_ == ClockSource::Tsc ? "TSC" : "steady_clock";
+}
+
+std::vector<int> available_cpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+        return cpus;
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &set)) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+bool pin_current_thread(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
 }
 
 uint64_t tomas_wang_int32_hash(uint32_t key) {
@@ -134,25 +534,514 @@ uint64_t tomas_wang_int64_hash(uint64_t key) {
     return key;
 }
 
+uint64_t LatencyHistogram::bucket_upper_bound(size_t index) {
+    if (index < (1ULL << kSubBucketBits)) {
+        return index;
+    }
+    size_t shift = index / kHalfSubBuckets - 1;
+    uint64_t mantissa = index - shift * kHalfSubBuckets;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    if (count_ == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(count_) + 0.5);
+    rank = std::clamp<uint64_t>(rank, 1, count_);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets_.size(); i++) {
+        seen += buckets_[i];
+        if (seen >= rank) {
+            return std::min(bucket_upper_bound(i), max_);
+        }
+    }
+    return max_;
+}
+
+LatencySummary LatencyHistogram::summary(double ns_per_tick) const {
+    LatencySummary s;
+    s.samples = count_;
+    s.p50 = static_cast<double>(percentile(50.0)) * ns_per_tick;
+    s.p99 = static_cast<double>(percentile(99.0)) * ns_per_tick;
+    s.p999 = static_cast<double>(percentile(99.9)) * ns_per_tick;
+    s.max = static_cast<double>(max_) * ns_per_tick;
+    return s;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < buckets_.size(); i++) {
+        buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::clear() {
+    std::fill(buckets_.begin(), buckets_.end(), 0);
+    count_ = 0;
+    max_ = 0;
+}
+
+const char* op_type_name(OpType type) {
+    switch (type) {
+        case OpType::Insert: return "insert";
+        case OpType::Update: return "update";
+        case OpType::LookupHit: return "read";
+        case OpType::LookupMiss: return "miss";
+        case OpType::Erase: return "erase";
+        case OpType::ReadModifyWrite: return "rmw";
+    }
+    return "unknown";
+}
+
+bool parse_workload(const std::string& spec, WorkloadMix& mix) {
+    mix = WorkloadMix{};
+    mix.name = spec;
+    
+    std::string preset = spec.rfind("ycsb-", 0) == 0 ? spec.substr(5) : spec;
+    double* r = mix.ratios;
+    auto at = [r](OpType type) -> double& { return r[static_cast<size_t>(type)]; };
+    
+    if (preset == "a") {
+        at(OpType::LookupHit) = 50;
+        at(OpType::Update) = 50;
+    } else if (preset == "b") {
+        at(OpType::LookupHit) = 95;
+        at(OpType::Update) = 5;
+    } else if (preset == "c") {
+        at(OpType::LookupHit) = 100;
+    } else if (preset == "d") {
+        at(OpType::LookupHit) = 95;
+        at(OpType::Insert) = 5;
+    } else if (preset == "f") {
+        at(OpType::LookupHit) = 50;
+        at(OpType::ReadModifyWrite) = 50;
+    } else {
+        // insert:update:hit:miss:erase[:rmw]
+        std::stringstream ss(spec);
+        std::string field;
+        size_t n = 0;
+        while (std::getline(ss, field, ':')) {
+            if (n == kNumOpTypes || field.empty()) {
+                return false;
+            }
+            char* end = nullptr;
+            double value = strtod(field.c_str(), &end);
+            if (*end != '\0' || value < 0) {
+                return false;
+            }
+            r[n++] = value;
+        }
+        if (n < kNumOpTypes - 1) {
+            return false;
+        }
+    }
+    return std::accumulate(std::begin(mix.ratios), std::end(mix.ratios), 0.0) > 0;
+}
+
+bool parse_sweep(const std::string& spec, double lower, double upper, std::vector<double>& points) {
+    points.clear();
+    std::stringstream ss(spec);
+    std::string field;
+    std::vector<double> values;
+    while (std::getline(ss, field, ':')) {
+        char* end = nullptr;
+        double value = strtod(field.c_str(), &end);
+        if (field.empty() || *end != '\0') {
+            return false;
+        }
+        values.push_back(value);
+    }
+    if (values.size() == 1) {
+        values = {values[0], values[0], 1};
+    }
+    if (values.size() != 3) {
+        return false;
+    }
+    double first = values[0], last = values[1], step = values[2];
+    if (!(first > lower && first <= last && last <= upper && step > 0)) {
+        return false;
+    }
+    // Points from the index, so 0.05 steps do not drift past MAX
+    for (size_t i = 0;; i++) {
+        double point = first + static_cast<double>(i) * step;
+        if (point > last + step * 1e-6) {
+            break;
+        }
+        points.push_back(std::min(point, last));
+    }
+    return true;
+}
+
+Workload generate_workload(const WorkloadMix& mix, size_t num_keys, size_t num_ops, uint64_t seed) {
+    Workload workload;
+    workload.name = mix.name;
+    workload.preload = num_keys / 2;
+    workload.ops.reserve(num_ops);
+    
+    std::vector<uint32_t> live(workload.preload);
+    std::iota(live.begin(), live.end(), 0);
+    std::vector<uint32_t> erased;
+    size_t next_fresh = workload.preload;
+    
+    std::mt19937_64 rng(seed);
+    std::discrete_distribution<int> pick(std::begin(mix.ratios), std::end(mix.ratios));
+    
+    for (size_t i = 0; i < num_ops && num_keys > 0; i++) {
+        OpType type = static_cast<OpType>(pick(rng));
+        
+        // Fall back to a neighbouring type when the chosen key pool is empty
+        bool needs_live = type == OpType::Update || type == OpType::LookupHit ||
+                          type == OpType::Erase || type == OpType::ReadModifyWrite;
+        if (needs_live && live.empty()) {
+            type = next_fresh < num_keys ? OpType::Insert : OpType::LookupMiss;
+        }
+        if (type == OpType::Insert && next_fresh == num_keys) {
+            type = live.empty() ? OpType::LookupMiss : OpType::Update;
+        }
+        if (type == OpType::LookupMiss && next_fresh == num_keys && erased.empty()) {
+            type = OpType::LookupHit;
+        }
+        
+        uint32_t key_index = 0;
+        switch (type) {
+            case OpType::Insert:
+                key_index = static_cast<uint32_t>(next_fresh++);
+                live.push_back(key_index);
+                break;
+            case OpType::Update:
+            case OpType::LookupHit:
+            case OpType::ReadModifyWrite:
+                key_index = live[rng() % live.size()];
+                break;
+            case OpType::Erase: {
+                size_t pos = rng() % live.size();
+                key_index = live[pos];
+                live[pos] = live.back();
+                live.pop_back();
+                erased.push_back(key_index);
+                break;
+            }
+            case OpType::LookupMiss:
+                if (next_fresh < num_keys) {
+                    key_index = static_cast<uint32_t>(next_fresh + rng() % (num_keys - next_fresh));
+                } else {
+                    key_index = erased[rng() % erased.size()];
+                }
+                break;
+        }
+        workload.ops.push_back({type, key_index});
+        workload.op_counts[static_cast<size_t>(type)]++;
+    }
+    return workload;
+}
+
+std::string describe_workload(const Workload& workload) {
+    std::ostringstream out;
+    out << "Workload " << workload.name << ": " << workload.preload << " keys preloaded, "
+        << workload.ops.size() << " ops (";
+    bool first = true;
+    for (size_t i = 0; i < kNumOpTypes; i++) {
+        if (workload.op_counts[i] == 0) {
+            continue;
+        }
+        double pct = 100.0 * static_cast<double>(workload.op_counts[i]) / static_cast<double>(workload.ops.size());
+        out << (first ? "" : ", ") << op_type_name(static_cast<OpType>(i)) << " "
+            << std::fixed << std::setprecision(1) << pct << "%";
+        first = false;
+    }
+    out << ")";
+    return out.str();
+}
+
+static void print_latency(const LatencySummary& latency) {
+    std::cout << std::setprecision(0)
+              << latency.p50 << "\t" << latency.p99 << "\t"
+              << latency.p999 << "\t" << latency.max << "\t";
+}
+
+static void print_memory(const BenchmarkResult& result) {
+    double mb = static_cast<double>(result.memory_bytes) / (1024.0 * 1024.0);
+    double per_entry = result.num_elements > 0
+        ? static_cast<double>(result.memory_bytes) / static_cast<double>(result.num_elements) : 0.0;
+    double overhead = result.raw_bytes > 0
+        ? static_cast<double>(result.memory_bytes) / static_cast<double>(result.raw_bytes) : 0.0;
+    std::cout << std::setprecision(1) << mb << "\t"
+              << std::setprecision(1) << per_entry << "\t"
+              << std::setprecision(2) << overhead << "x\t";
+}
+
+double SampleStats::relative_ci() const {
+    if (n < 2 || mean == 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return ci95 / mean;
+}
+
+double student_t_975(size_t dof) {
+    static const double table[] = {
+        0,      12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+    };
+    if (dof == 0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    if (dof < std::size(table)) {
+        return table[dof];
+    }
+    return dof < 60 ? 2.000 : (dof < 120 ? 1.980 : 1.960);
+}
+
+SampleStats compute_stats(std::vector<double> samples) {
+    SampleStats stats;
+    stats.n = samples.size();
+    if (samples.empty()) {
+        return stats;
+    }
+    std::sort(samples.begin(), samples.end());
+    size_t mid = samples.size() / 2;
+    stats.min = samples.front();
+    stats.median = samples.size() % 2 ? samples[mid] : (samples[mid - 1] + samples[mid]) / 2;
+    stats.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+    if (samples.size() > 1) {
+        double sq = 0;
+        for (double x : samples) {
+            sq += (x - stats.mean) * (x - stats.mean);
+        }
+        stats.stddev = std::sqrt(sq / (samples.size() - 1));
+        stats.ci95 = student_t_975(samples.size() - 1) * stats.stddev / std::sqrt(samples.size());
+    }
+    return stats;
+}
+
+bool same_configuration(const AggregateResult& a, const AggregateResult& b) {
+    return a.impl_name == b.impl_name && a.key_type == b.key_type && a.num_elements == b.num_elements &&
+           a.num_threads == b.num_threads && a.workload == b.workload &&
+           a.access_pattern == b.access_pattern && a.load_factor == b.load_factor;
+}
+
+std::vector<AggregateResult> aggregate_results(const std::vector<BenchmarkResult>& results) {
+    struct Samples {
+        std::vector<double> insert, query, miss, memory, insert_dtlb, query_dtlb;
+    };
+    std::vector<AggregateResult> aggregates;
+    std::vector<Samples> samples;
+    
+    for (const auto& r : results) {
+        AggregateResult key;
+        key.impl_name = r.impl_name;
+        key.key_type = r.key_type;
+        key.num_elements = r.num_elements;
+        key.num_threads = r.num_threads;
+        key.workload = r.workload;
+        key.access_pattern = r.access_pattern;
+        key.load_factor = r.load_factor;
+        auto it = std::find_if(aggregates.begin(), aggregates.end(), [&key](const AggregateResult& a) {
+            return same_configuration(a, key);
+        });
+        size_t index = it - aggregates.begin();
+        if (it == aggregates.end()) {
+            aggregates.push_back(key);
+            samples.emplace_back();
+        }
+        double query_ops = r.num_ops > 0 ? r.num_ops : r.num_elements;
+        samples[index].insert.push_back(r.num_elements / r.insert_time_sec / 1000000.0);
+        samples[index].query.push_back(query_ops / r.query_time_sec / 1000000.0);
+        if (r.miss_time_sec > 0) {
+            samples[index].miss.push_back(r.num_elements / r.miss_time_sec / 1000000.0);
+        }
+        samples[index].memory.push_back(static_cast<double>(r.memory_bytes));
+        aggregates[index].occupancy = r.occupancy;
+        if (r.insert_perf.has(PerfEvent::DtlbMisses)) {
+            samples[index].insert_dtlb.push_back(r.insert_perf[PerfEvent::DtlbMisses]);
+        }
+        if (r.query_perf.has(PerfEvent::DtlbMisses)) {
+            samples[index].query_dtlb.push_back(r.query_perf[PerfEvent::DtlbMisses]);
+        }
+    }
+    
+    for (size_t i = 0; i < aggregates.size(); i++) {
+        aggregates[i].insert_mops = compute_stats(std::move(samples[i].insert));
+        aggregates[i].query_mops = compute_stats(std::move(samples[i].query));
+        aggregates[i].miss_mops = compute_stats(std::move(samples[i].miss));
+        aggregates[i].memory_bytes = compute_stats(std::move(samples[i].memory));
+        aggregates[i].insert_dtlb_misses = compute_stats(std::move(samples[i].insert_dtlb));
+        aggregates[i].query_dtlb_misses = compute_stats(std::move(samples[i].query_dtlb));
+    }
+    return aggregates;
+}
+
 void print_result(const BenchmarkResult& result) {
     double insert_mops = result.num_elements / result.insert_time_sec / 1000000.0;
-    double query_mops = result.num_elements / result.query_time_sec / 1000000.0;
+    double query_ops = result.num_ops > 0 ? result.num_ops : result.num_elements;
+    double query_mops = query_ops / result.query_time_sec / 1000000.0;
     
     std::cout << std::left << std::setw(28) << result.impl_name
               << std::fixed << std::setprecision(6) << result.insert_time_sec << "\t"
               << std::setprecision(6) << result.query_time_sec << "\t"
               << std::setprecision(1) << insert_mops << "\t"
-              << std::setprecision(1) << query_mops << "\t"
-              << result.comments
+              << std::setprecision(1) << query_mops << "\t";
+    if (result.miss_time_sec > 0) {
+        std::cout << std::setprecision(6) << result.miss_time_sec << "\t"
+                  << std::setprecision(1) << result.num_elements / result.miss_time_sec / 1000000.0 << "\t";
+    }
+    if (result.destroy_time_sec > 0) {
+        if (std::isfinite(result.clear_time_sec)) {
+            std::cout << std::setprecision(6) << result.clear_time_sec << "\t";
+        } else {
+            std::cout << "-\t";
+        }
+        std::cout << std::setprecision(1) << result.num_elements / result.reuse_insert_time_sec / 1000000.0 << "\t"
+                  << std::setprecision(6) << result.destroy_time_sec << "\t";
+    }
+    print_memory(result);
+    if (result.insert_latency.samples > 0 || result.query_latency.samples > 0) {
+        print_latency(result.insert_latency);
+        print_latency(result.query_latency);
+    }
+    std::cout << result.comments
               << std::endl;
+    
+    struct Phase {
+        const char* name;
+        const PerfCounts& counts;
+    };
+    for (const Phase& phase : {Phase{"insert", result.insert_perf}, Phase{"query", result.query_perf},
+                               Phase{"miss", result.miss_perf}}) {
+        if (!phase.counts.any()) {
+            continue;
+        }
+        std::cout << "    perf/op " << std::setw(7) << phase.name;
+        for (size_t i = 0; i < kNumPerfEvents; i++) {
+            PerfEvent event = static_cast<PerfEvent>(i);
+            if (phase.counts.has(event)) {
+                std::cout << " " << perf_event_name(event) << " " << std::setprecision(2) << phase.counts[event];
+            }
+        }
+        std::cout << "\n";
+    }
+    
+    for (size_t i = 0; i < result.op_results.size(); i++) {
+        const OpTypeResult& op = result.op_results[i];
+        if (op.ops == 0) {
+            continue;
+        }
+        std::cout << "    op " << op_type_name(static_cast<OpType>(i)) << ": " << op.ops << " ops, "
+                  << std::setprecision(1) << op.mops << " Mops/s, p50/p99/p99.9/max " << std::setprecision(0)
+                  << op.latency.p50 << "/" << op.latency.p99 << "/" << op.latency.p999 << "/"
+                  << op.latency.max << " ns\n";
+    }
+    
+    if (!result.hugepages.empty()) {
+        std::cout << "    hugepages " << result.hugepages << ": " << std::setprecision(1)
+                  << result.huge_page_bytes / (1024.0 * 1024.0) << " MB huge-page backed";
+        if (result.memory_bytes > 0) {
+            std::cout << " (" << std::setprecision(0)
+                      << 100.0 * result.huge_page_bytes / result.memory_bytes << "% of the map)";
+        }
+        std::cout << "\n";
+    }
+    
+    if (result.query_node >= 0) {
+        std::cout << "    remote query from node " << result.query_node << ": " << std::setprecision(1)
+                  << query_ops / result.remote_query_time_sec / 1000000.0 << " Mops/s ("
+                  << std::setprecision(2) << result.remote_query_time_sec / result.query_time_sec
+                  << "x local time)\n";
+    }
+    
+    if (result.view_query_time_sec > 0) {
+        std::cout << "    string_view query " << std::setprecision(1)
+                  << query_ops / result.view_query_time_sec / 1000000.0 << " Mops/s ("
+                  << std::setprecision(2) << result.query_time_sec / result.view_query_time_sec
+                  << "x query phase), " << (result.view_transparent ? "transparent" : "copied")
+                  << "\n";
+    }
+    
+    if (result.batch_size > 0) {
+        double batch_insert_mops = result.num_elements / result.batch_insert_time_sec / 1000000.0;
+        double batch_query_mops = result.num_elements / result.batch_query_time_sec / 1000000.0;
+        std::cout << "    batch " << result.batch_size << (result.batch_pipelined ? " prefetch" : " scalar  ")
+                  << " insert " << std::setprecision(1) << batch_insert_mops << " Mops/s ("
+                  << std::setprecision(2) << result.insert_time_sec / result.batch_insert_time_sec
+                  << "x), query " << std::setprecision(1) << batch_query_mops << " Mops/s ("
+                  << std::setprecision(2) << result.query_time_sec / result.batch_query_time_sec << "x)\n";
+    }
+    
+    if (result.capacity_traced) {
+        const RehashEvent* worst = nullptr;
+        double total_sec = 0;
+        for (const RehashEvent& event : result.rehash_events) {
+            total_sec += event.sec;
+            if (worst == nullptr || event.sec > worst->sec) {
+                worst = &event;
+            }
+        }
+        std::cout << "    growth (traced pass): " << result.rehash_events.size() << " resizes";
+        if (worst != nullptr) {
+            std::cout << ", " << std::setprecision(2) << total_sec * 1000.0 << " ms in resizing inserts ("
+                      << std::setprecision(0) << 100.0 * total_sec / result.traced_insert_time_sec
+                      << "% of the pass), worst " << std::setprecision(2) << worst->sec * 1000.0 << " ms at "
+                      << worst->size << " entries (" << worst->old_capacity << " -> " << worst->new_capacity << ")";
+        }
+        std::cout << "\n";
+    }
+    
+    if (result.num_threads > 1) {
+        std::cout << "    per-thread insert Mops/s:";
+        for (double sec : result.thread_insert_sec) {
+            double n = static_cast<double>(result.num_elements) / result.num_threads;
+            std::cout << " " << std::setprecision(1) << n / sec / 1000000.0;
+        }
+        std::cout << "\n    per-thread query Mops/s: ";
+        for (double sec : result.thread_query_sec) {
+            double n = static_cast<double>(result.num_elements) / result.num_threads;
+            std::cout << " " << std::setprecision(1) << n / sec / 1000000.0;
+        }
+        std::cout << std::endl;
+    }
 }
 
 void print_results(const std::vector<BenchmarkResult>& results) {
+    bool has_latency = std::any_of(results.begin(), results.end(), [](const BenchmarkResult& r) {
+        return r.insert_latency.samples > 0 || r.query_latency.samples > 0;
+    });
+    
+    bool is_workload = std::any_of(results.begin(), results.end(), [](const BenchmarkResult& r) {
+        return r.num_ops > 0;
+    });
+    
+    bool has_miss = std::any_of(results.begin(), results.end(), [](const BenchmarkResult& r) {
+        return r.miss_time_sec > 0;
+    });
+    
+    bool has_teardown = std::any_of(results.begin(), results.end(), [](const BenchmarkResult& r) {
+        return r.destroy_time_sec > 0;
+    });
+    
     std::cout << "\n";
     std::cout << std::left 
               << std::setw(28) << "Implementation" << "\t"
-              << "Insert (s)\tQuery (s)\tInsert Mops/s\tQuery Mops/s\tComments\n";
-    std::cout << std::string(100, '-') << "\n";
+              << (is_workload ? "Load (s)\tRun (s)\tLoad Mops/s\tRun Mops/s\t"
+                              : "Insert (s)\tQuery (s)\tInsert Mops/s\tQuery Mops/s\t")
+              << (has_miss ? "Miss (s)\tMiss Mops/s\t" : "")
+              << (has_teardown ? "Clear (s)\tReuse Mops/s\tDestroy (s)\t" : "")
+              << "Mem (MB)\tBytes/entry\tOverhead\t";
+    if (has_latency) {
+        if (is_workload) {
+            std::cout << "Load p50\tLoad p99\tLoad p99.9\tLoad max\t"
+                      << "Run p50\tRun p99\tRun p99.9\tRun max\t";
+        } else {
+            std::cout << "Ins p50\tIns p99\tIns p99.9\tIns max\t"
+                      << "Qry p50\tQry p99\tQry p99.9\tQry max\t";
+        }
+    }
+    std::cout << "Comments\n";
+    std::cout << std::string((has_latency ? 210 : 130) + (has_miss ? 24 : 0) + (has_teardown ? 36 : 0), '-') << "\n";
+    if (has_latency) {
+        std::cout << "(latency columns in ns)\n";
+    }
     
     for (const auto& result : results) {
         print_result(result);
@@ -160,4 +1049,464 @@ void print_results(const std::vector<BenchmarkResult>& results) {
     std::cout << std::endl;
 }
 
+static std::string format_load_factor(double load_factor) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2) << load_factor;
+    return out.str();
+}
+
+static void print_stats_row(const AggregateResult& a, const char* phase, const SampleStats& stats) {
+    std::string label = a.impl_name;
+    if (a.load_factor > 0) {
+        label += " @" + format_load_factor(a.load_factor);
+    }
+    std::cout << std::left << std::setw(28) << label
+              << std::setw(14) << a.key_type
+              << std::setw(8) << phase
+              << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << stats.min
+              << std::setw(10) << stats.median
+              << std::setw(10) << stats.mean
+              << std::setw(10) << stats.stddev
+              << std::setw(10) << stats.ci95;
+    if (stats.n > 1) {
+        std::cout << std::setw(9) << std::setprecision(1) << stats.relative_ci() * 100 << "%";
+    }
+    std::cout << std::left << "\n";
+}
+
+void print_summary(const std::vector<AggregateResult>& aggregates) {
+    if (aggregates.empty()) {
+        return;
+    }
+    bool is_workload = std::any_of(aggregates.begin(), aggregates.end(), [](const AggregateResult& a) {
+        return !a.workload.empty();
+    });
+    
+    std::cout << "\n=== Summary over " << aggregates.front().query_mops.n << " repetitions (Mops/s) ===\n\n";
+    std::cout << std::left << std::setw(28) << "Implementation" << std::setw(14) << "Key type"
+              << std::setw(8) << "Phase" << std::right
+              << std::setw(10) << "Min" << std::setw(10) << "Median" << std::setw(10) << "Mean"
+              << std::setw(10) << "Stddev" << std::setw(10) << "95% CI" << std::setw(10) << "CI/mean"
+              << std::left << "\n";
+    std::cout << std::string(110, '-') << "\n";
+    for (const auto& a : aggregates) {
+        print_stats_row(a, is_workload ? "load" : "insert", a.insert_mops);
+        print_stats_row(a, is_workload ? "run" : "query", a.query_mops);
+        if (a.miss_mops.n > 0) {
+            print_stats_row(a, "miss", a.miss_mops);
+        }
+    }
+    std::cout << std::endl;
+}
+
+void print_load_factor_sweep(const std::vector<AggregateResult>& aggregates) {
+    // Points arrive grouped by load factor; regroup them per implementation
+    std::vector<std::pair<std::string, std::string>> series;
+    for (const auto& a : aggregates) {
+        auto id = std::make_pair(a.impl_name, a.key_type);
+        if (a.load_factor > 0 && std::find(series.begin(), series.end(), id) == series.end()) {
+            series.push_back(id);
+        }
+    }
+    if (series.empty()) {
+        return;
+    }
+    
+    std::cout << "\n=== Load factor sweep (median Mops/s) ===\n\n";
+    std::cout << std::left << std::setw(28) << "Implementation" << std::setw(14) << "Key type" << std::right
+              << std::setw(8) << "Target" << std::setw(11) << "Occupancy" << std::setw(10) << "Insert"
+              << std::setw(10) << "Query" << std::setw(10) << "Miss" << std::setw(13) << "Bytes/entry"
+              << std::left << "\n";
+    std::cout << std::string(104, '-') << "\n";
+    for (const auto& [impl_name, key_type] : series) {
+        for (const auto& a : aggregates) {
+            if (a.load_factor <= 0 || a.impl_name != impl_name || a.key_type != key_type) {
+                continue;
+            }
+            std::cout << std::left << std::setw(28) << a.impl_name << std::setw(14) << a.key_type
+                      << std::right << std::setw(8) << format_load_factor(a.load_factor);
+            if (a.occupancy > 0) {
+                std::cout << std::setw(11) << format_load_factor(a.occupancy);
+            } else {
+                std::cout << std::setw(11) << "-";
+            }
+            std::cout << std::fixed << std::setprecision(1)
+                      << std::setw(10) << a.insert_mops.median << std::setw(10) << a.query_mops.median;
+            if (a.miss_mops.n > 0) {
+                std::cout << std::setw(10) << a.miss_mops.median;
+            } else {
+                std::cout << std::setw(10) << "-";
+            }
+            std::cout << std::setw(13) << a.memory_bytes.median / std::max<uint64_t>(a.num_elements, 1)
+                      << std::left << "\n";
+        }
+    }
+    std::cout << std::endl;
+}
+
+void print_key_length_sweep(const std::vector<AggregateResult>& aggregates,
+                            const std::vector<std::string>& key_types) {
+    std::vector<std::string> impls;
+    for (const auto& a : aggregates) {
+        if (std::find(key_types.begin(), key_types.end(), a.key_type) != key_types.end() &&
+            std::find(impls.begin(), impls.end(), a.impl_name) == impls.end()) {
+            impls.push_back(a.impl_name);
+        }
+    }
+    if (impls.empty()) {
+        return;
+    }
+    
+    for (bool query : {false, true}) {
+        std::cout << "\n=== Key length sweep: " << (query ? "query" : "insert") << " (median Mops/s) ===\n\n";
+        std::cout << std::left << std::setw(28) << "Implementation" << std::right;
+        for (const auto& key_type : key_types) {
+            std::cout << std::setw(10) << key_type;
+        }
+        std::cout << std::left << "\n" << std::string(28 + 10 * key_types.size(), '-') << "\n";
+        for (const auto& impl : impls) {
+            std::cout << std::left << std::setw(28) << impl << std::right << std::fixed << std::setprecision(1);
+            for (const auto& key_type : key_types) {
+                auto it = std::find_if(aggregates.begin(), aggregates.end(), [&](const AggregateResult& a) {
+                    return a.impl_name == impl && a.key_type == key_type;
+                });
+                if (it == aggregates.end()) {
+                    std::cout << std::setw(10) << "-";
+                } else {
+                    std::cout << std::setw(10) << (query ? it->query_mops.median : it->insert_mops.median);
+                }
+            }
+            std::cout << std::left << "\n";
+        }
+    }
+    std::cout << std::endl;
+}
+
+// ============================================================================
+// Machine-readable export
+// ============================================================================
+
+// Written at build time by cmake/git_sha.cmake
+#if __has_include("git_sha.h")
+#include "git_sha.h"
+#endif
+#ifndef HASHMAP_BENCH_GIT_SHA
+#define HASHMAP_BENCH_GIT_SHA "unknown"
+#endif
+#ifndef HASHMAP_BENCH_BUILD_FLAGS
+#define HASHMAP_BENCH_BUILD_FLAGS "unknown"
+#endif
+
+bool parse_output_format(const std::string& name, OutputFormat& format) {
+    if (name == "table") {
+        format = OutputFormat::Table;
+    } else if (name == "csv") {
+        format = OutputFormat::Csv;
+    } else if (name == "jsonl") {
+        format = OutputFormat::Jsonl;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static std::string read_first_line(const char* path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+static std::string read_cpu_model() {
+    std::ifstream in("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind("model name", 0) == 0) {
+            size_t colon = line.find(':');
+            if (colon != std::string::npos) {
+                return line.substr(line.find_first_not_of(' ', colon + 1));
+            }
+        }
+    }
+    return "unknown";
+}
+
+RunMetadata collect_run_metadata() {
+    RunMetadata metadata;
+    
+    char buf[64];
+    time_t now = time(nullptr);
+    struct tm utc;
+    gmtime_r(&now, &utc);
+    strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", &utc);
+    metadata.timestamp = buf;
+    
+    char host[256] = {};
+    metadata.hostname = gethostname(host, sizeof(host) - 1) == 0 ? host : "unknown";
+    metadata.cpu_model = read_cpu_model();
+    metadata.governor = read_first_line("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor");
+    if (metadata.governor.empty()) {
+        metadata.governor = "unknown";
+    }
+#if defined(__clang__)
+    metadata.compiler = "clang " __clang_version__;
+#elif defined(__GNUC__)
+    metadata.compiler = "gcc " __VERSION__;
+#else
+    metadata.compiler = "unknown";
+#endif
+    metadata.build_flags = HASHMAP_BENCH_BUILD_FLAGS;
+    metadata.git_sha = HASHMAP_BENCH_GIT_SHA;
+    
+    std::ostringstream clock;
+    clock << Clock::source_name();
+    if (Clock::source() == ClockSource::Tsc) {
+        clock << " " << std::fixed << std::setprecision(3) << 1.0 / Clock::ns_per_tick() << " GHz";
+    }
+    metadata.clock = clock.str();
+    return metadata;
+}
+
+namespace {
+
+// One exported column; lists become JSON arrays or ';'-joined CSV cells
+struct ExportField {
+    enum Kind { Number, Text, NumberList };
+    std::string name;
+    Kind kind;
+    std::string text;
+    std::vector<double> list;
+};
+
+// Empty for inf and nan (a rate over zero elapsed time, say), which JSON has
+// no literal for; written as null, or as an empty CSV cell
+std::string format_number(double value) {
+    if (!std::isfinite(value)) {
+        return "";
+    }
+    std::ostringstream out;
+    out << std::setprecision(10) << value;
+    return out.str();
+}
+
+ExportField number(const std::string& name, double value) {
+    return {name, ExportField::Number, format_number(value), {}};
+}
+
+ExportField text(const std::string& name, const std::string& value) {
+    return {name, ExportField::Text, value, {}};
+}
+
+ExportField number_list(const std::string& name, const std::vector<double>& values) {
+    return {name, ExportField::NumberList, "", values};
+}
+
+ExportField integer(const std::string& name, uint64_t value) {
+    return {name, ExportField::Number, std::to_string(value), {}};
+}
+
+const char* const kInsertLatencyFields[] = {
+    "insert_latency_samples", "insert_latency_p50_ns", "insert_latency_p99_ns",
+    "insert_latency_p999_ns", "insert_latency_max_ns",
+};
+const char* const kQueryLatencyFields[] = {
+    "query_latency_samples", "query_latency_p50_ns", "query_latency_p99_ns",
+    "query_latency_p999_ns", "query_latency_max_ns",
+};
+
+void add_latency(std::vector<ExportField>& fields, const char* const (&names)[5],
+                 const LatencySummary& latency) {
+    fields.push_back(integer(names[0], latency.samples));
+    fields.push_back(number(names[1], latency.p50));
+    fields.push_back(number(names[2], latency.p99));
+    fields.push_back(number(names[3], latency.p999));
+    fields.push_back(number(names[4], latency.max));
+}
+
+// <phase>_<event>_per_op columns, empty / null when the counter was not read
+void add_perf(std::vector<ExportField>& fields, const std::string& phase, const PerfCounts& counts) {
+    for (size_t i = 0; i < kNumPerfEvents; i++) {
+        PerfEvent event = static_cast<PerfEvent>(i);
+        std::string name = phase + "_" + perf_event_name(event) + "_per_op";
+        std::replace(name.begin(), name.end(), '-', '_');
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        fields.push_back(counts.has(event) ? number(name, counts[event])
+                                           : ExportField{name, ExportField::Number, "", {}});
+    }
+}
+
+std::vector<ExportField> export_fields(const BenchmarkResult& r, const RunMetadata& m) {
+    double query_ops = r.num_ops > 0 ? r.num_ops : r.num_elements;
+    std::vector<ExportField> fields = {
+        text("timestamp", m.timestamp),
+        text("hostname", m.hostname),
+        text("cpu_model", m.cpu_model),
+        text("governor", m.governor),
+        text("compiler", m.compiler),
+        text("build_flags", m.build_flags),
+        text("git_sha", m.git_sha),
+        text("clock", m.clock),
+        integer("num_power", m.num_power),
+        integer("seed", m.seed),
+        integer("repetition", r.repetition),
+        text("impl_name", r.impl_name),
+        text("key_type", r.key_type),
+        integer("num_elements", r.num_elements),
+        integer("num_threads", r.num_threads),
+        text("workload", r.workload),
+        integer("num_ops", r.num_ops),
+        text("access_pattern", r.access_pattern),
+        number("insert_time_sec", r.insert_time_sec),
+        number("query_time_sec", r.query_time_sec),
+        number("miss_time_sec", r.miss_time_sec),
+        number("clear_time_sec", r.clear_time_sec),
+        number("reuse_insert_time_sec", r.reuse_insert_time_sec),
+        number("destroy_time_sec", r.destroy_time_sec),
+        number("insert_mops", r.num_elements / r.insert_time_sec / 1000000.0),
+        number("query_mops", query_ops / r.query_time_sec / 1000000.0),
+        integer("memory_bytes", r.memory_bytes),
+        integer("peak_memory_bytes", r.peak_memory_bytes),
+        integer("raw_bytes", r.raw_bytes),
+        number_list("thread_insert_sec", r.thread_insert_sec),
+        number_list("thread_query_sec", r.thread_query_sec),
+    };
+    add_latency(fields, kInsertLatencyFields, r.insert_latency);
+    add_latency(fields, kQueryLatencyFields, r.query_latency);
+    add_perf(fields, "insert", r.insert_perf);
+    add_perf(fields, "query", r.query_perf);
+    add_perf(fields, "miss", r.miss_perf);
+    fields.push_back(number("query_node", r.query_node));
+    fields.push_back(number("remote_query_time_sec", r.remote_query_time_sec));
+    fields.push_back(text("hugepages", r.hugepages));
+    fields.push_back(integer("huge_page_bytes", r.huge_page_bytes));
+    fields.push_back(integer("batch_size", r.batch_size));
+    fields.push_back(integer("batch_pipelined", r.batch_pipelined));
+    fields.push_back(number("batch_insert_time_sec", r.batch_insert_time_sec));
+    fields.push_back(number("batch_query_time_sec", r.batch_query_time_sec));
+    for (size_t i = 0; i < kNumOpTypes; i++) {
+        OpTypeResult op = i < r.op_results.size() ? r.op_results[i] : OpTypeResult{};
+        std::string prefix = std::string("op_") + op_type_name(static_cast<OpType>(i));
+        fields.push_back(integer(prefix + "_ops", op.ops));
+        fields.push_back(number(prefix + "_mops", op.mops));
+        fields.push_back(number(prefix + "_p50_ns", op.latency.p50));
+        fields.push_back(number(prefix + "_p99_ns", op.latency.p99));
+        fields.push_back(number(prefix + "_p999_ns", op.latency.p999));
+        fields.push_back(number(prefix + "_max_ns", op.latency.max));
+    }
+    fields.push_back(integer("key_store", r.key_store));
+    fields.push_back(number("view_query_time_sec", r.view_query_time_sec));
+    fields.push_back(integer("view_transparent", r.view_transparent));
+    std::vector<double> rehash_sizes;
+    std::vector<double> rehash_old_capacities;
+    std::vector<double> rehash_capacities;
+    std::vector<double> rehash_sec;
+    for (const RehashEvent& event : r.rehash_events) {
+        rehash_sizes.push_back(static_cast<double>(event.size));
+        rehash_old_capacities.push_back(static_cast<double>(event.old_capacity));
+        rehash_capacities.push_back(static_cast<double>(event.new_capacity));
+        rehash_sec.push_back(event.sec);
+    }
+    fields.push_back(number("load_factor", r.load_factor));
+    fields.push_back(number("occupancy", r.occupancy));
+    fields.push_back(integer("reserved", r.reserved));
+    fields.push_back(integer("capacity_traced", r.capacity_traced));
+    fields.push_back(number_list("rehash_sizes", rehash_sizes));
+    fields.push_back(number_list("rehash_old_capacities", rehash_old_capacities));
+    fields.push_back(number_list("rehash_capacities", rehash_capacities));
+    fields.push_back(number_list("rehash_sec", rehash_sec));
+    fields.push_back(number("traced_insert_time_sec", r.traced_insert_time_sec));
+    fields.push_back(text("comments", r.comments));
+    return fields;
+}
+
+std::string csv_escape(const std::string& value) {
+    if (value.find_first_of(",\"\n\r") == std::string::npos) {
+        return value;
+    }
+    std::string quoted = "\"";
+    for (char c : value) {
+        if (c == '"') {
+            quoted += '"';
+        }
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+std::string json_escape(const std::string& value) {
+    std::string escaped;
+    for (unsigned char c : value) {
+        switch (c) {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    escaped += buf;
+                } else {
+                    escaped += static_cast<char>(c);
+                }
+        }
+    }
+    return escaped;
+}
+
+// missing stands in for the non-finite values
+std::string join_numbers(const std::vector<double>& values, const char* separator, const char* missing) {
+    std::string joined;
+    for (size_t i = 0; i < values.size(); i++) {
+        std::string value = format_number(values[i]);
+        joined += (i ? separator : "") + (value.empty() ? std::string(missing) : value);
+    }
+    return joined;
+}
+
+} // namespace
+
+void write_results(std::ostream& out, OutputFormat format,
+                   const std::vector<BenchmarkResult>& results, const RunMetadata& metadata) {
+    if (format == OutputFormat::Table) {
+        print_results(results);
+        return;
+    }
+    
+    bool header = format == OutputFormat::Csv;
+    for (const auto& result : results) {
+        std::vector<ExportField> fields = export_fields(result, metadata);
+        if (header) {
+            for (size_t i = 0; i < fields.size(); i++) {
+                out << (i ? "," : "") << fields[i].name;
+            }
+            out << "\n";
+            header = false;
+        }
+        
+        if (format == OutputFormat::Csv) {
+            for (size_t i = 0; i < fields.size(); i++) {
+                const ExportField& f = fields[i];
+                out << (i ? "," : "")
+                    << csv_escape(f.kind == ExportField::NumberList ? join_numbers(f.list, ";", "") : f.text);
+            }
+        } else {
+            out << "{";
+            for (size_t i = 0; i < fields.size(); i++) {
+                const ExportField& f = fields[i];
+                out << (i ? "," : "") << "\"" << f.name << "\":";
+                switch (f.kind) {
+                    case ExportField::Number: out << (f.text.empty() ? "null" : f.text); break;
+                    case ExportField::Text: out << "\"" << json_escape(f.text) << "\""; break;
+                    case ExportField::NumberList: out << "[" << join_numbers(f.list, ",", "null") << "]"; break;
+                }
+            }
+            out << "}";
+        }
+        out << "\n";
+    }
+    out.flush();
+}
+
 } // namespace hashmap_bench
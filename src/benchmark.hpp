@@ -1,16 +1,53 @@
 #pragma once
 
 #include <chrono>
+#include <algorithm>
 #include <cstdint>
 #include <cstdio>
 #include <functional>
+#include <iosfwd>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
-#include <sys/time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "memory_tracker.hpp"
+#include "perf_counters.hpp"
 
 namespace hashmap_bench {
 
+// Percentile summary of a sampled latency histogram (ns)
+struct LatencySummary {
+    uint64_t samples = 0;
+    double p50 = 0;
+    double p99 = 0;
+    double p999 = 0;
+    double max = 0;
+};
+
+// One growth step seen during an insert phase: the table held size entries
+// when the insert that resized it from old_capacity to new_capacity ran, and
+// that insert took sec
+struct RehashEvent {
+    uint64_t size = 0;
+    size_t old_capacity = 0;
+    size_t new_capacity = 0;
+    double sec = 0;
+};
+
+// One operation type of a sampled workload run (-w or --trace, with -l): how
+// many ops of the type ran, and the latency of the sampled ones. mops is the
+// sampled ops over their summed latency, the rate of that type on its own.
+struct OpTypeResult {
+    uint64_t ops = 0;
+    double mops = 0;
+    LatencySummary latency;
+};
+
 // Benchmark result structure
 struct BenchmarkResult {
     std::string impl_name;
@@ -18,44 +55,310 @@ struct BenchmarkResult {
     uint64_t num_elements;
     double insert_time_sec;
     double query_time_sec;
-    size_t memory_bytes;
+    double miss_time_sec = 0;      // num_elements lookups of absent keys; 0 if not run
+    double destroy_time_sec = 0;   // destroy() and freeing the map; 0 if not timed
+    // clear() of the full map; 0 if not timed, NaN (blank in the output) for
+    // wrappers without clear(), whose erase loop is not comparable
+    double clear_time_sec = 0;
+    double reuse_insert_time_sec = 0;  // num_elements inserts into the cleared map
+    size_t memory_bytes = 0;       // live heap after create + insert (memory pass)
     std::string comments;
+
+    // Memory accounting: peak heap during create + insert, and the
+    // raw key + value payload the map holds
+    size_t peak_memory_bytes = 0;
+    size_t raw_bytes = 0;
+
+    // Concurrent mode (-t): aggregate times above, per-thread times here
+    int num_threads = 1;
+    std::vector<double> thread_insert_sec;
+    std::vector<double> thread_query_sec;
+
+    // Sampled per-operation latency (-l); samples == 0 when disabled
+    LatencySummary insert_latency;
+    LatencySummary query_latency;
+
+    // Mixed workload (-w): insert columns cover the preload, query columns
+    // the replayed operation stream of num_ops operations
+    std::string workload;
+    uint64_t num_ops = 0;
+
+    // Query-phase access distribution (-d); empty for sequential
+    std::string access_pattern;
+
+    // 1-based repetition that produced this result (-r)
+    int repetition = 1;
+
+    // Hardware counters per operation of each phase (--perf); all invalid
+    // when disabled or unavailable
+    PerfCounts insert_perf;
+    PerfCounts query_perf;
+    PerfCounts miss_perf;
+
+    // Lookups and inserts replayed in groups of batch_size keys (--batch); 0
+    // when off. batch_pipelined is false for wrappers that only loop scalar.
+    uint32_t batch_size = 0;
+    bool batch_pipelined = false;
+    double batch_insert_time_sec = 0;
+    double batch_query_time_sec = 0;
+
+    // Query phase repeated from the CPUs of query_node after building the
+    // map on the home node (--query-node); -1 when off
+    int query_node = -1;
+    double remote_query_time_sec = 0;
+
+    // Workload runs with latency sampling, broken down by operation type and
+    // indexed by OpType; empty otherwise
+    std::vector<OpTypeResult> op_results;
+
+    // String keys came from the contiguous KeyStore (the default) rather
+    // than the generated std::string objects (--scattered-keys)
+    bool key_store = false;
+
+    // Query phase repeated with std::string_view keys (--view-lookup); 0 when
+    // off. view_transparent is false where each view was copied to a string.
+    double view_query_time_sec = 0;
+    bool view_transparent = false;
+
+    // Huge page mode of the container allocator (--hugepages) and how many
+    // bytes of the map were huge-page backed after the insert phase; empty
+    // and 0 when off
+    std::string hugepages;
+    size_t huge_page_bytes = 0;
+
+    // Containers created empty instead of pre-sized (--no-reserve), and the
+    // resizes traced in a separate insert pass for wrappers that report their
+    // capacity; capacity_traced is false for the others
+    bool reserved = true;
+    bool capacity_traced = false;
+    std::vector<RehashEvent> rehash_events;
+    double traced_insert_time_sec = 0;  // the whole traced pass
+
+    // Target occupancy of a --load-factor-sweep point (0 outside a sweep),
+    // and num_elements / capacity() after the insert phase for wrappers that
+    // report a capacity (0 for the others)
+    double load_factor = 0;
+    double occupancy = 0;
+};
+
+// Capacity handed to Wrapper::create() for n keys: n, or 0 with --no-reserve
+// so every container starts empty and grows as the keys arrive
+inline bool reserve_capacity = true;
+
+inline size_t initial_capacity(size_t n) {
+    return reserve_capacity ? n : 0;
+}
+
+// Raw cycle counter (TSC on x86)
+inline uint64_t read_cycle_counter() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Timing backends
+enum class ClockSource {
+    Tsc,          // invariant TSC, calibrated against CLOCK_MONOTONIC_RAW
+    SteadyClock   // std::chrono::steady_clock
 };
 
-// Time measurement helper
-inline double get_time_diff(const struct timeval& start, const struct timeval& end) {
-    long sec = end.tv_sec - start.tv_sec;
-    long usec = end.tv_usec - start.tv_usec;
-    if (usec < 0) {
-        sec--;
-        usec += 1000000;
+// Process-wide clock used by Timer and latency sampling.
+// init() falls back to steady_clock when the TSC is not invariant.
+class Clock {
+public:
+    static void init(ClockSource preferred);
+    static bool has_invariant_tsc();
+    
+    static uint64_t now() {
+        if (source_ == ClockSource::Tsc) {
+            return read_cycle_counter();
+        }
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
     }
-    return static_cast<double>(sec) + static_cast<double>(usec) / 1000000.0;
+    
+    static ClockSource source() { return source_; }
+    static const char* source_name();
+    static double ns_per_tick() { return ns_per_tick_; }
+    static double ticks_to_sec(uint64_t ticks) { return static_cast<double>(ticks) * ns_per_tick_ * 1e-9; }
+    // Cost of one now() call, subtracted from every measured interval
+    static uint64_t overhead_ticks() { return overhead_ticks_; }
+    static double overhead_ns() { return static_cast<double>(overhead_ticks_) * ns_per_tick_; }
+
+private:
+    static uint64_t measure_overhead();
+    
+    static inline ClockSource source_ = ClockSource::SteadyClock;
+    static inline double ns_per_tick_ = 1.0;
+    static inline uint64_t overhead_ticks_ = 0;
+};
+
+// Ticks since start, less the cost of the clock read itself
+inline uint64_t sample_ticks(uint64_t start) {
+    uint64_t ticks = Clock::now() - start;
+    return ticks > Clock::overhead_ticks() ? ticks - Clock::overhead_ticks() : 0;
 }
 
 // Timer class for RAII-style timing
 class Timer {
 public:
-    Timer() { gettimeofday(&start_, nullptr); }
+    Timer() { start_ = Clock::now(); }
     
     double elapsed() const {
-        struct timeval end;
-        gettimeofday(&end, nullptr);
-        return get_time_diff(start_, end);
+        uint64_t ticks = Clock::now() - start_;
+        uint64_t overhead = Clock::overhead_ticks();
+        return Clock::ticks_to_sec(ticks > overhead ? ticks - overhead : 0);
     }
     
-    void reset() { gettimeofday(&start_, nullptr); }
+    void reset() { start_ = Clock::now(); }
+
+private:
+    uint64_t start_;
+};
+
+// Log-linear (HDR-style) histogram: values below 2^kSubBucketBits are exact,
+// larger values keep kSubBucketBits - 1 bits of mantissa (~3% resolution)
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 6;
+    static constexpr int kHalfSubBuckets = 1 << (kSubBucketBits - 1);
+    static constexpr size_t kNumBuckets = (64 - kSubBucketBits + 1) * kHalfSubBuckets + kHalfSubBuckets;
+
+    LatencyHistogram() : buckets_(kNumBuckets, 0) {}
+
+    void record(uint64_t value) {
+        buckets_[bucket_index(value)]++;
+        count_++;
+        if (value > max_) {
+            max_ = value;
+        }
+    }
+
+    uint64_t count() const { return count_; }
+    uint64_t max() const { return max_; }
+    // Highest value equivalent to the bucket holding the p-th percentile
+    uint64_t percentile(double p) const;
+    LatencySummary summary(double ns_per_tick = 1.0) const;
+    void merge(const LatencyHistogram& other);
+    void clear();
+
+    static size_t bucket_index(uint64_t value) {
+        if (value < (1ULL << kSubBucketBits)) {
+            return static_cast<size_t>(value);
+        }
+        int shift = 63 - __builtin_clzll(value) - (kSubBucketBits - 1);
+        return static_cast<size_t>(shift) * kHalfSubBuckets + static_cast<size_t>(value >> shift);
+    }
+    static uint64_t bucket_upper_bound(size_t index);
 
 private:
-    struct timeval start_;
+    std::vector<uint64_t> buckets_;
+    uint64_t count_ = 0;
+    uint64_t max_ = 0;
 };
 
-// Key generation functions
+// Key generation functions. Each key depends only on its index, so large
+// sets are filled in parallel ranges, one thread per available CPU.
 void generate_short_keys(std::vector<std::string>& keys, int num_power);
 void generate_mid_keys(std::vector<std::string>& keys, int num_power);
 void generate_long_keys(std::vector<std::string>& keys, int num_power);
 void generate_int_keys(std::vector<uint64_t>& keys, int num_power);
 
+// Parametric string keys (-k str:LEN or str:MIN-MAX). Each key is a common
+// prefix of prefix_len characters, a pseudo-random filler and its index as a
+// fixed-width base-|alphabet| suffix, so keys are unique at any length that
+// leaves room for the suffix. Lengths are uniform over [min_len, max_len].
+inline constexpr const char* kAlnumAlphabet =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+
+struct KeySpec {
+    size_t min_len = 16;
+    size_t max_len = 16;
+    std::string alphabet = kAlnumAlphabet;
+    size_t prefix_len = 0;
+};
+
+// "str:LEN" or "str:MIN-MAX"; alphabet and prefix_len are left untouched
+bool parse_key_spec(const std::string& key_type, KeySpec& spec);
+
+// alnum, hex, digits or printable, else the distinct characters of text;
+// at least two, all ASCII, since miss keys flip the high bit
+bool parse_key_alphabet(const std::string& text, std::string& alphabet);
+
+// Shortest key that holds the prefix and the unique suffix of n keys
+size_t min_key_length(const KeySpec& spec, uint64_t n);
+
+// spec.min_len must be at least min_key_length(spec, 2^num_power)
+void generate_string_keys(std::vector<std::string>& keys, int num_power, const KeySpec& spec, uint64_t seed);
+
+// Keys guaranteed absent from keys, one per key, for the miss-lookup phase;
+// each candidate is checked against a sorted copy of keys, and the
+// dense/sparse_hash_map markers are skipped. String misses flip one bit of
+// the key, the high bit of the first byte when that is free (always for
+// ASCII keys), so they keep the length and probe the same table regions;
+// integer misses count up from the largest key, wrapping past ~0.
+void generate_miss_keys(const std::vector<std::string>& keys, std::vector<std::string>& misses);
+void generate_miss_keys(const std::vector<uint64_t>& keys, std::vector<uint64_t>& misses);
+
+// String keys packed back to back in one buffer, with an offset index, so
+// walking them touches consecutive cache lines instead of one heap block per
+// key past the SSO length. The string suite inserts and queries from it by
+// default: wrappers with a transparent lookup probe these views, the others
+// std::string keys rebuilt from it once (--scattered-keys opts out).
+class KeyStore {
+public:
+    KeyStore() = default;
+    explicit KeyStore(const std::vector<std::string>& keys) { assign(keys); }
+    
+    void assign(const std::vector<std::string>& keys);
+    // The first n of keys, e.g. views into a mapped --keys-file
+    void assign(const std::string_view* keys, size_t n);
+    void clear() {
+        data_.clear();
+        offsets_.assign(1, 0);
+    }
+    
+    size_t size() const { return offsets_.size() - 1; }
+    bool empty() const { return size() == 0; }
+    std::string_view operator[](size_t i) const {
+        return std::string_view(data_.data() + offsets_[i], offsets_[i + 1] - offsets_[i]);
+    }
+    // Total key bytes in the buffer
+    size_t bytes() const { return data_.size(); }
+    
+private:
+    std::string data_;
+    std::vector<size_t> offsets_ = {0};
+};
+
+// Query-phase key access distributions (-d)
+enum class AccessPattern { Sequential, Uniform, Zipfian, HotSet, Latest };
+
+struct AccessDistribution {
+    AccessPattern pattern = AccessPattern::Sequential;
+    double theta = 0.99;              // Zipfian / latest skew, in (0, 1)
+    double hot_op_fraction = 0.9;     // hot-set: share of ops that hit ...
+    double hot_key_fraction = 0.1;    // ... this share of the keys
+};
+
+// Accepts "seq", "uniform", "zipf[:THETA]", "hotset[:OPS:KEYS]" (fractions
+// or percentages) and "latest[:THETA]"
+bool parse_access_distribution(const std::string& spec, AccessDistribution& dist);
+std::string describe_access_distribution(const AccessDistribution& dist);
+
+// Fill indices with num_ops key indices in [0, num_keys) drawn from dist.
+// Zipfian and hot-set ranks are scattered over a seeded permutation so the
+// hot keys are not adjacent in insertion order; latest makes the most
+// recently inserted keys the hottest. Sequential leaves indices empty.
+void generate_access_indices(std::vector<uint32_t>& indices, size_t num_keys, size_t num_ops,
+                             const AccessDistribution& dist, uint64_t seed);
+
+// Thread placement helpers
+std::vector<int> available_cpus();
+bool pin_current_thread(int cpu);
+
 // Hash functions
 uint64_t tomas_wang_int32_hash(uint32_t key);
 uint64_t tomas_wang_int64_hash(uint64_t key);
@@ -110,8 +413,281 @@ public:
     }
 };
 
+// Raw key + value payload, the baseline for the memory overhead column
+inline size_t raw_kv_bytes(const std::vector<std::string>& keys) {
+    size_t bytes = keys.size() * sizeof(uint64_t);
+    for (const auto& key : keys) {
+        bytes += key.size();
+    }
+    return bytes;
+}
+
+inline size_t raw_kv_bytes(const std::vector<uint64_t>& keys) {
+    return keys.size() * (sizeof(uint64_t) + sizeof(uint64_t));
+}
+
+// Untimed memory pass: a fresh map filled with keys [0, count) on the calling
+// thread while the allocator hook counts. Runs after the timed phases so they
+// never pay for the accounting.
+template <typename Wrapper, typename Key>
+void measure_memory(const std::vector<Key>& keys, size_t count, BenchmarkResult& result) {
+    using Map = typename Wrapper::Map;
+    memory_tracking_start();
+    std::unique_ptr<Map> map(new Map(Wrapper::create(initial_capacity(keys.size()))));
+    for (size_t i = 0; i < count; i++) {
+        Wrapper::insert(*map, keys[i], uint64_t{0});
+    }
+    result.memory_bytes = memory_live_bytes();
+    result.peak_memory_bytes = memory_peak_bytes();
+    memory_tracking_stop();
+    Wrapper::destroy(*map);
+}
+
+// ============================================================================
+// Mixed read/write workload engine (YCSB-style)
+// ============================================================================
+
+enum class OpType : uint8_t {
+    Insert,           // key not yet in the map
+    Update,           // overwrite a live key
+    LookupHit,
+    LookupMiss,       // key never inserted or already erased
+    Erase,
+    ReadModifyWrite,  // lookup + update of the same live key
+};
+constexpr size_t kNumOpTypes = 6;
+
+const char* op_type_name(OpType type);
+
+// Relative operation frequencies, indexed by OpType
+struct WorkloadMix {
+    std::string name;
+    double ratios[kNumOpTypes] = {};
+};
+
+// Presets ycsb-a, ycsb-b, ycsb-c, ycsb-d, ycsb-f (scans of ycsb-e are not
+// supported) or custom ratios "insert:update:hit:miss:erase[:rmw]"
+bool parse_workload(const std::string& spec, WorkloadMix& mix);
+
+struct Operation {
+    OpType type;
+    uint32_t key_index;
+};
+
+// Pre-generated operation stream over a key vector: keys [0, preload) are
+// loaded before the run, later keys feed inserts and misses
+struct Workload {
+    std::string name;
+    size_t preload = 0;
+    std::vector<Operation> ops;
+    uint64_t op_counts[kNumOpTypes] = {};
+};
+
+Workload generate_workload(const WorkloadMix& mix, size_t num_keys, size_t num_ops, uint64_t seed);
+std::string describe_workload(const Workload& workload);
+
+// Replays a Workload through a wrapper (create/insert/update/lookup/
+// contains/erase/destroy). Generation stays outside the timed region.
+template <typename Wrapper>
+class WorkloadBenchmark {
+public:
+    using Map = typename Wrapper::Map;
+    
+    template <typename Key>
+    static BenchmarkResult run(
+        const std::string& impl_name,
+        const std::string& key_type,
+        const std::vector<Key>& keys,
+        const Workload& workload,
+        uint64_t sample_every = 0,
+        const std::string& comments = "") {
+        
+        BenchmarkResult result;
+        result.impl_name = impl_name;
+        result.key_type = key_type;
+        result.num_elements = workload.preload;
+        result.comments = comments;
+        result.workload = workload.name;
+        result.num_ops = workload.ops.size();
+        
+        // Load phase
+        Map map = Wrapper::create(initial_capacity(keys.size()));
+        Timer timer;
+        for (size_t i = 0; i < workload.preload; i++) {
+            Wrapper::insert(map, keys[i], value_for(i));
+        }
+        result.insert_time_sec = timer.elapsed();
+        result.raw_bytes = raw_kv_bytes(keys) * workload.preload / std::max<size_t>(keys.size(), 1);
+        
+        // Run phase
+        uint64_t sum = 0;
+        timer.reset();
+        if (sample_every == 0) {
+            for (const Operation& op : workload.ops) {
+                sum += apply(map, keys, op);
+            }
+        } else {
+            LatencyHistogram hist;
+            LatencyHistogram type_hist[kNumOpTypes];
+            uint64_t type_ticks[kNumOpTypes] = {};
+            uint64_t countdown = sample_every;
+            for (const Operation& op : workload.ops) {
+                if (--countdown == 0) {
+                    countdown = sample_every;
+                    uint64_t start = Clock::now();
+                    sum += apply(map, keys, op);
+                    uint64_t ticks = sample_ticks(start);
+                    hist.record(ticks);
+                    type_hist[static_cast<size_t>(op.type)].record(ticks);
+                    type_ticks[static_cast<size_t>(op.type)] += ticks;
+                } else {
+                    sum += apply(map, keys, op);
+                }
+            }
+            result.query_latency = hist.summary(Clock::ns_per_tick());
+            result.op_results.resize(kNumOpTypes);
+            for (size_t i = 0; i < kNumOpTypes; i++) {
+                OpTypeResult& op_result = result.op_results[i];
+                op_result.ops = workload.op_counts[i];
+                op_result.latency = type_hist[i].summary(Clock::ns_per_tick());
+                double ns = static_cast<double>(type_ticks[i]) * Clock::ns_per_tick();
+                op_result.mops = ns > 0 ? op_result.latency.samples / ns * 1000.0 : 0;
+            }
+        }
+        result.query_time_sec = timer.elapsed();
+        side_effect += sum;
+        
+        Wrapper::destroy(map);
+        measure_memory<Wrapper>(keys, workload.preload, result);
+        
+        return result;
+    }
+
+private:
+    // Non-zero, since CLHT and rhashmap read a stored 0 back as a miss
+    static uint64_t value_for(size_t key_index) { return key_index + 1; }
+    
+    template <typename Key>
+    static uint64_t apply(Map& map, const std::vector<Key>& keys, const Operation& op) {
+        const Key& key = keys[op.key_index];
+        switch (op.type) {
+            case OpType::Insert:
+                Wrapper::insert(map, key, value_for(op.key_index));
+                return 0;
+            case OpType::Update:
+                Wrapper::update(map, key, value_for(op.key_index));
+                return 0;
+            case OpType::LookupHit:
+                return Wrapper::lookup(map, key);
+            case OpType::LookupMiss:
+                return Wrapper::contains(map, key);
+            case OpType::Erase:
+                Wrapper::erase(map, key);
+                return 0;
+            case OpType::ReadModifyWrite: {
+                uint64_t value = Wrapper::lookup(map, key);
+                Wrapper::update(map, key, value + 1);
+                return value;
+            }
+        }
+        return 0;
+    }
+};
+
+// ============================================================================
+// Repetition statistics (-r, --warmup, --target-ci)
+// ============================================================================
+
+struct SampleStats {
+    size_t n = 0;
+    double min = 0;
+    double median = 0;
+    double mean = 0;
+    double stddev = 0;   // sample standard deviation (n - 1)
+    double ci95 = 0;     // half-width of the 95% confidence interval of the mean
+    
+    // CI half-width relative to the mean; infinite until there are two samples
+    double relative_ci() const;
+};
+
+SampleStats compute_stats(std::vector<double> samples);
+
+// Two-sided 97.5% quantile of Student's t distribution
+double student_t_975(size_t dof);
+
+// One (impl, key type, N, threads, workload, access pattern) group
+// aggregated over repetitions
+struct AggregateResult {
+    std::string impl_name;
+    std::string key_type;
+    uint64_t num_elements = 0;
+    int num_threads = 1;
+    std::string workload;
+    std::string access_pattern;
+    double load_factor = 0;
+    double occupancy = 0;    // from the last result of the group
+    SampleStats insert_mops;
+    SampleStats query_mops;
+    SampleStats miss_mops;   // n == 0 when the miss phase did not run
+    SampleStats memory_bytes;
+    SampleStats insert_dtlb_misses;  // per operation; n == 0 without --perf
+    SampleStats query_dtlb_misses;
+};
+
+// Groups results by (impl, key type, N, threads, workload, access pattern,
+// load factor) in first-seen order
+std::vector<AggregateResult> aggregate_results(const std::vector<BenchmarkResult>& results);
+
+// Whether two aggregates describe the same configuration, i.e. the grouping
+// key of aggregate_results()
+bool same_configuration(const AggregateResult& a, const AggregateResult& b);
+
+// Sweep points "MIN:MAX:STEP" (MIN, MIN + STEP, ... up to MAX inclusive)
+// with lower < MIN <= MAX <= upper and STEP > 0; a lone "V" is one point
+bool parse_sweep(const std::string& spec, double lower, double upper, std::vector<double>& points);
+
 // Result printer
 void print_result(const BenchmarkResult& result);
 void print_results(const std::vector<BenchmarkResult>& results);
+void print_summary(const std::vector<AggregateResult>& aggregates);
+
+// Median Mops/s and bytes/entry per --load-factor-sweep point, one block per
+// implementation and key type
+void print_load_factor_sweep(const std::vector<AggregateResult>& aggregates);
+
+// Median insert and query Mops/s of every implementation against the key
+// types of a --key-len-sweep, one column per key type
+void print_key_length_sweep(const std::vector<AggregateResult>& aggregates,
+                            const std::vector<std::string>& key_types);
+
+// ============================================================================
+// Machine-readable export (--format, --output)
+// ============================================================================
+
+enum class OutputFormat { Table, Csv, Jsonl };
+
+// Accepts "table", "csv" and "jsonl"
+bool parse_output_format(const std::string& name, OutputFormat& format);
+
+// Host, build and run parameters attached to every exported record
+struct RunMetadata {
+    std::string timestamp;     // UTC, ISO 8601
+    std::string hostname;
+    std::string cpu_model;
+    std::string governor;      // cpufreq scaling governor of cpu0
+    std::string compiler;
+    std::string build_flags;
+    std::string git_sha;
+    std::string clock;
+    int num_power = 0;
+    uint64_t seed = 0;
+};
+
+// Fills the host and build fields; callers set num_power and seed
+RunMetadata collect_run_metadata();
+
+// One CSV header + row per result, or one JSON object per line
+void write_results(std::ostream& out, OutputFormat format,
+                   const std::vector<BenchmarkResult>& results, const RunMetadata& metadata);
 
 } // namespace hashmap_bench
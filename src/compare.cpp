@@ -0,0 +1,261 @@
+#include "compare.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+
+namespace hashmap_bench {
+
+namespace {
+
+// Minimal reader for the flat objects write_results emits: string, number
+// and number-array values, no nesting. Array values are kept verbatim.
+bool parse_flat_json(const std::string& line, std::map<std::string, std::string>& fields) {
+    size_t pos = 0;
+    auto skip_space = [&] {
+        while (pos < line.size() && isspace(static_cast<unsigned char>(line[pos]))) {
+            pos++;
+        }
+    };
+    auto parse_string = [&](std::string& out) {
+        if (pos >= line.size() || line[pos] != '"') {
+            return false;
+        }
+        pos++;
+        out.clear();
+        while (pos < line.size() && line[pos] != '"') {
+            char c = line[pos++];
+            if (c == '\\' && pos < line.size()) {
+                char e = line[pos++];
+                switch (e) {
+                    case 'n': out += '\n'; break;
+                    case 't': out += '\t'; break;
+                    case 'u':
+                        if (pos + 4 > line.size()) {
+                            return false;
+                        }
+                        out += static_cast<char>(strtol(line.substr(pos, 4).c_str(), nullptr, 16));
+                        pos += 4;
+                        break;
+                    default: out += e; break;
+                }
+            } else {
+                out += c;
+            }
+        }
+        if (pos >= line.size()) {
+            return false;
+        }
+        pos++;
+        return true;
+    };
+
+    fields.clear();
+    skip_space();
+    if (pos >= line.size() || line[pos++] != '{') {
+        return false;
+    }
+    while (true) {
+        skip_space();
+        if (pos < line.size() && line[pos] == '}') {
+            return true;
+        }
+        std::string key;
+        if (!parse_string(key)) {
+            return false;
+        }
+        skip_space();
+        if (pos >= line.size() || line[pos++] != ':') {
+            return false;
+        }
+        skip_space();
+        std::string value;
+        if (pos < line.size() && line[pos] == '"') {
+            if (!parse_string(value)) {
+                return false;
+            }
+        } else {
+            size_t end = line[pos] == '[' ? line.find(']', pos) + 1 : line.find_first_of(",}", pos);
+            if (end == std::string::npos || end == 0) {
+                return false;
+            }
+            value = line.substr(pos, end - pos);
+            pos = end;
+        }
+        fields[key] = value;
+        skip_space();
+        if (pos < line.size() && line[pos] == ',') {
+            pos++;
+        } else if (pos >= line.size() || line[pos] != '}') {
+            return false;
+        }
+    }
+}
+
+double field_number(const std::map<std::string, std::string>& fields, const char* name) {
+    auto it = fields.find(name);
+    return it == fields.end() ? 0.0 : strtod(it->second.c_str(), nullptr);
+}
+
+std::string field_text(const std::map<std::string, std::string>& fields, const char* name) {
+    auto it = fields.find(name);
+    return it == fields.end() ? std::string() : it->second;
+}
+
+} // namespace
+
+bool load_results_jsonl(const std::string& path, std::vector<BenchmarkResult>& results,
+                        std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+
+    std::string line;
+    size_t line_number = 0;
+    std::map<std::string, std::string> fields;
+    while (std::getline(in, line)) {
+        line_number++;
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        if (!parse_flat_json(line, fields) || !fields.count("impl_name") ||
+            !fields.count("insert_time_sec")) {
+            error = path + ":" + std::to_string(line_number) + ": not a hashmap_bench jsonl record";
+            return false;
+        }
+        BenchmarkResult r;
+        r.impl_name = field_text(fields, "impl_name");
+        r.key_type = field_text(fields, "key_type");
+        r.num_elements = static_cast<uint64_t>(field_number(fields, "num_elements"));
+        r.num_threads = std::max(1, static_cast<int>(field_number(fields, "num_threads")));
+        r.workload = field_text(fields, "workload");
+        r.num_ops = static_cast<uint64_t>(field_number(fields, "num_ops"));
+        r.access_pattern = field_text(fields, "access_pattern");
+        r.repetition = static_cast<int>(field_number(fields, "repetition"));
+        r.insert_time_sec = field_number(fields, "insert_time_sec");
+        r.query_time_sec = field_number(fields, "query_time_sec");
+        r.miss_time_sec = field_number(fields, "miss_time_sec");
+        r.load_factor = field_number(fields, "load_factor");
+        r.memory_bytes = static_cast<size_t>(field_number(fields, "memory_bytes"));
+        r.peak_memory_bytes = static_cast<size_t>(field_number(fields, "peak_memory_bytes"));
+        r.raw_bytes = static_cast<size_t>(field_number(fields, "raw_bytes"));
+        r.comments = field_text(fields, "comments");
+        // null when the baseline ran without --perf or the counter was unavailable
+        for (auto [phase, counts] : {std::pair{"insert", &r.insert_perf}, std::pair{"query", &r.query_perf}}) {
+            std::string name = std::string(phase) + "_dtlb_miss_per_op";
+            std::string value = field_text(fields, name.c_str());
+            if (!value.empty() && value != "null") {
+                size_t event = static_cast<size_t>(PerfEvent::DtlbMisses);
+                counts->values[event] = strtod(value.c_str(), nullptr);
+                counts->valid[event] = true;
+            }
+        }
+        results.push_back(r);
+    }
+    return true;
+}
+
+WelchTest welch_t_test(const SampleStats& baseline, const SampleStats& current) {
+    WelchTest test;
+    if (baseline.n < 2 || current.n < 2) {
+        return test;
+    }
+    test.testable = true;
+
+    double vb = baseline.stddev * baseline.stddev / baseline.n;
+    double vc = current.stddev * current.stddev / current.n;
+    double diff = current.mean - baseline.mean;
+    if (vb + vc == 0) {
+        // Both sides noiseless (e.g. deterministic memory): any difference is real
+        test.t = diff == 0 ? 0 : std::copysign(std::numeric_limits<double>::infinity(), diff);
+        test.dof = baseline.n + current.n - 2;
+        test.significant = diff != 0;
+        return test;
+    }
+    test.t = diff / std::sqrt(vb + vc);
+    test.dof = (vb + vc) * (vb + vc) /
+               (vb * vb / (baseline.n - 1) + vc * vc / (current.n - 1));
+    test.significant = std::abs(test.t) > student_t_975(static_cast<size_t>(std::max(1.0, test.dof)));
+    return test;
+}
+
+std::vector<Comparison> compare_results(const std::vector<AggregateResult>& baseline,
+                                        const std::vector<AggregateResult>& current,
+                                        double threshold) {
+    std::vector<Comparison> comparisons;
+    for (const auto& cur : current) {
+        auto base = std::find_if(baseline.begin(), baseline.end(), [&cur](const AggregateResult& b) {
+            return same_configuration(b, cur);
+        });
+        if (base == baseline.end()) {
+            continue;
+        }
+
+        auto add = [&](const char* metric, const SampleStats& b, const SampleStats& c, bool higher_is_better) {
+            if (b.n == 0 || c.n == 0 || b.mean == 0) {
+                return;
+            }
+            Comparison cmp;
+            cmp.impl_name = cur.impl_name;
+            cmp.key_type = cur.key_type;
+            cmp.num_elements = cur.num_elements;
+            cmp.metric = metric;
+            cmp.baseline = b.mean;
+            cmp.current = c.mean;
+            cmp.change = (c.mean - b.mean) / b.mean;
+            cmp.test = welch_t_test(b, c);
+            double worse = higher_is_better ? -cmp.change : cmp.change;
+            cmp.regression = worse > threshold && (cmp.test.significant || !cmp.test.testable);
+            comparisons.push_back(cmp);
+        };
+        add("insert_mops", base->insert_mops, cur.insert_mops, true);
+        add("query_mops", base->query_mops, cur.query_mops, true);
+        add("memory_bytes", base->memory_bytes, cur.memory_bytes, false);
+        add("insert_dtlb_miss", base->insert_dtlb_misses, cur.insert_dtlb_misses, false);
+        add("query_dtlb_miss", base->query_dtlb_misses, cur.query_dtlb_misses, false);
+    }
+    return comparisons;
+}
+
+void print_comparison(const std::vector<Comparison>& comparisons, const std::string& baseline_name,
+                      double threshold) {
+    std::cout << "\n=== Comparison against " << baseline_name << " (threshold "
+              << std::fixed << std::setprecision(1) << threshold * 100 << "%) ===\n\n";
+    std::cout << std::left << std::setw(28) << "Implementation" << std::setw(14) << "Key type"
+              << std::setw(10) << "N" << std::setw(18) << "Metric" << std::right
+              << std::setw(14) << "Baseline" << std::setw(14) << "Current"
+              << std::setw(10) << "Change" << std::setw(9) << "t" << "  " << std::left << "Verdict\n";
+    std::cout << std::string(129, '-') << "\n";
+
+    size_t regressions = 0;
+    for (const auto& c : comparisons) {
+        const char* verdict = c.regression ? "REGRESSION"
+                            : !c.test.testable ? "ok (single sample)"
+                            : c.test.significant ? "ok (significant)"
+                            : "ok";
+        regressions += c.regression;
+        std::cout << std::left << std::setw(28) << c.impl_name << std::setw(14) << c.key_type
+                  << std::setw(10) << c.num_elements << std::setw(18) << c.metric << std::right
+                  << std::setprecision(2) << std::setw(14) << c.baseline << std::setw(14) << c.current
+                  << std::showpos << std::setprecision(1) << std::setw(9) << c.change * 100 << "%"
+                  << std::setprecision(2) << std::setw(9);
+        if (c.test.testable) {
+            std::cout << c.test.t;
+        } else {
+            std::cout << "-";
+        }
+        std::cout << std::noshowpos << "  " << std::left << verdict << "\n";
+    }
+    std::cout << "\n" << regressions << " regression(s) in " << comparisons.size()
+              << " compared metrics\n" << std::endl;
+}
+
+} // namespace hashmap_bench
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "benchmark.hpp"
+
+namespace hashmap_bench {
+
+// Baseline comparison (--compare): a stored JSON Lines export is aggregated
+// like the current run and each group of the same configuration (impl, key
+// type, N, threads, workload, access pattern, load factor) is compared
+// metric by metric.
+
+// Read the records written by --format=jsonl; returns false and sets error
+// when the file cannot be read or a line is not a result record
+bool load_results_jsonl(const std::string& path, std::vector<BenchmarkResult>& results,
+                        std::string& error);
+
+// Welch's unequal-variance t-test of current against baseline means
+struct WelchTest {
+    double t = 0;
+    double dof = 0;
+    bool significant = false;  // two-sided, 5% level; false with < 2 samples on either side
+    bool testable = false;
+};
+
+WelchTest welch_t_test(const SampleStats& baseline, const SampleStats& current);
+
+struct Comparison {
+    std::string impl_name;
+    std::string key_type;
+    uint64_t num_elements = 0;
+    std::string metric;           // insert_mops, query_mops, memory_bytes, {insert,query}_dtlb_miss
+    double baseline = 0;          // means
+    double current = 0;
+    double change = 0;            // (current - baseline) / baseline
+    WelchTest test;
+    bool regression = false;
+};
+
+// A metric regresses when it moves the wrong way (lower Mops/s, more bytes or
+// dTLB misses per operation) by more than threshold and the move is
+// significant, or cannot be tested because one side has a single sample.
+// dTLB metrics are compared only when both runs used --perf.
+std::vector<Comparison> compare_results(const std::vector<AggregateResult>& baseline,
+                                        const std::vector<AggregateResult>& current,
+                                        double threshold);
+
+void print_comparison(const std::vector<Comparison>& comparisons, const std::string& baseline_name,
+                      double threshold);
+
+} // namespace hashmap_bench
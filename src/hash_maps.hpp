@@ -1,7 +1,15 @@
 #pragma once
 
+#include <algorithm>
 #include <string>
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <vector>
 
 // Standard library
 #include <unordered_map>
@@ -16,6 +24,7 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
 #include "absl/container/btree_map.h"
+#include "absl/strings/string_view.h"
 
 // Folly F14
 #include <folly/container/F14Map.h>
@@ -52,11 +61,219 @@ extern "C" {
 #include <ssmem.h>
 }
 
+#include "arena.hpp"
 #include "benchmark.hpp"
+#include "hugepages.hpp"
 
 namespace hashmap_bench {
 
-inline size_t clht_capacity_factor = 4;
+// CLHT is created with N * clht_capacity_factor / kClhtSlotsPerBucket
+// buckets for N keys, i.e. clht_capacity_factor slots per key (-c)
+inline size_t clht_capacity_factor = 3;
+inline constexpr size_t kClhtSlotsPerBucket = 3;
+
+// Target occupancy of a --load-factor-sweep point; 0 keeps each container's
+// default sizing. Containers with a settable maximum load factor get it set;
+// the open-addressing tables with a fixed one are reserved large enough that
+// n keys stay under the target. Power-of-two capacities still leave n keys
+// anywhere between half the target and the target, so the sweep inserts
+// sweep_key_count() keys instead of all of them.
+inline double target_load_factor = 0;
+
+// Capacity to reserve so that n keys fill a table whose own maximum load is
+// max_load to target_load_factor; n when no target is set
+inline size_t sized_for_load(size_t n, double max_load) {
+    if (target_load_factor <= 0) {
+        return n;
+    }
+    return static_cast<size_t>(static_cast<double>(n) * max_load / target_load_factor);
+}
+
+// Maximum load of the SwissTable-style tables (absl, phmap) and of F14,
+// which fills at most 12 of the 14 slots of a chunk
+inline constexpr double kSwissMaxLoad = 7.0 / 8.0;
+inline constexpr double kF14MaxLoad = 12.0 / 14.0;
+
+// The C tables reject or mis-size an empty table, so create(0) from
+// --no-reserve starts them at this size and lets them grow from there
+inline constexpr size_t kMinCreateCapacity = 16;
+
+// Containers that keep their entries, slots or buckets in large arrays take
+// this allocator so --hugepages can back those arrays with huge pages;
+// node-based trees, the C libraries and dense_hash_map, whose stock
+// allocator lets clear() shrink the table with realloc, keep their own
+template <typename Key, typename Value>
+using EntryAllocator = HugePageAllocator<std::pair<const Key, Value>>;
+
+// Every wrapper exposes find(), which returns std::nullopt on a miss, next
+// to lookup(), which may assume the key is present. This is the shared body
+// for the containers with an STL-style find().
+template <typename Value, typename Map, typename Key>
+inline std::optional<Value> find_entry(Map& m, const Key& k) {
+    auto it = m.find(k);
+    if (it == m.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+// Optional batch interface, for callers that look up or insert groups of keys:
+//   static void batch_lookup(Map&, const Key* keys, size_t n, Value* out);
+//   static void batch_insert(Map&, const Key* keys, size_t n, const Value* values);
+// Wrappers whose container exposes its hash or a prefetch hint implement them
+// by hashing and prefetching a window of keys before probing any of them, so
+// the window's cache misses overlap. lookup_batch() / insert_batch() fall
+// back to the scalar loop for the others.
+inline constexpr size_t kBatchWindow = 64;
+
+template <typename T, typename Key, typename Value, typename = void>
+struct has_batch_lookup : std::false_type {};
+
+template <typename T, typename Key, typename Value>
+struct has_batch_lookup<T, Key, Value, std::void_t<decltype(T::batch_lookup(
+    std::declval<typename T::Map&>(), std::declval<const Key*>(), size_t{},
+    std::declval<Value*>()))>> : std::true_type {};
+
+template <typename T, typename Key, typename Value, typename = void>
+struct has_batch_insert : std::false_type {};
+
+template <typename T, typename Key, typename Value>
+struct has_batch_insert<T, Key, Value, std::void_t<decltype(T::batch_insert(
+    std::declval<typename T::Map&>(), std::declval<const Key*>(), size_t{},
+    std::declval<const Value*>()))>> : std::true_type {};
+
+// prepare(i) hashes and prefetches key i and returns what probe(i, token)
+// needs to finish it; windows of kBatchWindow keys are prepared, then probed
+template <typename Token, typename Prepare, typename Probe>
+inline void pipelined(size_t n, Prepare prepare, Probe probe) {
+    Token tokens[kBatchWindow];
+    for (size_t base = 0; base < n; base += kBatchWindow) {
+        size_t end = std::min(n, base + kBatchWindow);
+        for (size_t i = base; i < end; i++) {
+            tokens[i - base] = prepare(i);
+        }
+        for (size_t i = base; i < end; i++) {
+            probe(i, tokens[i - base]);
+        }
+    }
+}
+
+template <typename Wrapper, typename Key, typename Value>
+inline void lookup_batch(typename Wrapper::Map& m, const Key* keys, size_t n, Value* out) {
+    if constexpr (has_batch_lookup<Wrapper, Key, Value>::value) {
+        Wrapper::batch_lookup(m, keys, n, out);
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            out[i] = Wrapper::lookup(m, keys[i]);
+        }
+    }
+}
+
+template <typename Wrapper, typename Key, typename Value>
+inline void insert_batch(typename Wrapper::Map& m, const Key* keys, size_t n, const Value* values) {
+    if constexpr (has_batch_insert<Wrapper, Key, Value>::value) {
+        Wrapper::batch_insert(m, keys, n, values);
+    } else {
+        for (size_t i = 0; i < n; i++) {
+            Wrapper::insert(m, keys[i], values[i]);
+        }
+    }
+}
+
+// Optional transparent lookup for string keys:
+//   static Value lookup_view(Map&, std::string_view);
+// Wrappers whose container hashes and compares a std::string_view against
+// its std::string keys directly implement it. lookup_by_view() copies the
+// view into a std::string for the others, which allocates past the SSO
+// capacity, as a lookup from a slice of a network buffer would.
+template <typename T, typename = void>
+struct has_lookup_view : std::false_type {};
+
+template <typename T>
+struct has_lookup_view<T, std::void_t<decltype(T::lookup_view(
+    std::declval<typename T::Map&>(), std::string_view{}))>> : std::true_type {};
+
+template <typename Wrapper>
+inline uint64_t lookup_by_view(typename Wrapper::Map& m, std::string_view k) {
+    if constexpr (has_lookup_view<Wrapper>::value) {
+        return Wrapper::lookup_view(m, k);
+    } else {
+        return Wrapper::lookup(m, std::string(k));
+    }
+}
+
+// std::hash / std::equal_to for the std containers, made transparent for
+// std::string keys so they can be probed with a std::string_view; the hash
+// values are the same as std::hash<std::string>'s
+struct TransparentStringHash {
+    using is_transparent = void;
+    size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+};
+
+template <typename Key>
+using StdHash = std::conditional_t<std::is_same_v<Key, std::string>, TransparentStringHash, std::hash<Key>>;
+template <typename Key>
+using StdKeyEqual = std::conditional_t<std::is_same_v<Key, std::string>, std::equal_to<>, std::equal_to<Key>>;
+
+// Optional in-place clear for the clear-and-reuse phase:
+//   static void clear(Map&);
+// Each container decides whether its storage survives the clear. The C
+// libraries have none, so clear_map() erases the given keys one by one.
+template <typename T, typename = void>
+struct has_clear : std::false_type {};
+
+template <typename T>
+struct has_clear<T, std::void_t<decltype(T::clear(std::declval<typename T::Map&>()))>> : std::true_type {};
+
+template <typename Wrapper, typename Key>
+inline void clear_map(typename Wrapper::Map& m, const std::vector<Key>& keys) {
+    if constexpr (has_clear<Wrapper>::value) {
+        Wrapper::clear(m);
+    } else {
+        for (const auto& key : keys) {
+            Wrapper::erase(m, key);
+        }
+    }
+}
+
+// Teardown phase: destroy() plus freeing the heap-held Map itself, timed
+// together so arena-backed maps and node maps are compared on the same work.
+// Returns seconds; the holder is empty afterwards.
+template <typename Wrapper>
+inline double destroy_map(std::unique_ptr<typename Wrapper::Map>& holder) {
+    Timer timer;
+    Wrapper::destroy(*holder);
+    holder.reset();
+    return timer.elapsed();
+}
+
+// Optional storage size, for tracing growth under --no-reserve:
+//   static size_t capacity(Map&);
+// Buckets or slots for hash tables, reserved elements for sorted vectors;
+// trees, cista and the C tables without a size query leave it out.
+template <typename T, typename = void>
+struct has_capacity : std::false_type {};
+
+template <typename T>
+struct has_capacity<T, std::void_t<decltype(T::capacity(std::declval<typename T::Map&>()))>> : std::true_type {};
+
+// Keys to insert at a --load-factor-sweep point: target_load_factor of the
+// capacity() that create(n / 2) gets, which is at most n. create() of that
+// many keys lands on the same capacity, so the map ends at the target rather
+// than wherever the rounding put n keys. n outside a sweep, under
+// --no-reserve and for wrappers without capacity().
+template <typename Wrapper>
+inline size_t sweep_key_count(size_t n) {
+    if constexpr (has_capacity<Wrapper>::value) {
+        if (target_load_factor > 0 && reserve_capacity) {
+            auto map = Wrapper::create(n / 2);
+            size_t capacity = Wrapper::capacity(map);
+            Wrapper::destroy(map);
+            return std::min(n, static_cast<size_t>(target_load_factor * static_cast<double>(capacity)));
+        }
+    }
+    return n;
+}
 
 // ============================================================================
 // std::unordered_map wrapper
@@ -64,12 +281,26 @@ inline size_t clht_capacity_factor = 4;
 template <typename Key, typename Value>
 class StdUnorderedMapWrapper {
 public:
-    using Map = std::unordered_map<Key, Value>;
+    using Map = std::unordered_map<Key, Value, StdHash<Key>, StdKeyEqual<Key>, EntryAllocator<Key, Value>>;
     static constexpr bool is_ordered = false;
     
-    static Map create(size_t capacity) { return Map(capacity); }
+    static Map create(size_t capacity) {
+        Map m;
+        if (target_load_factor > 0) {
+            m.max_load_factor(static_cast<float>(target_load_factor));
+        }
+        m.reserve(capacity);
+        return m;
+    }
     static void insert(Map& m, const Key& k, Value v) { m[k] = v; }
     static Value lookup(Map& m, const Key& k) { return m.at(k); }
+    static Value lookup_view(Map& m, std::string_view k) { return m.find(k)->second; }
+    static void update(Map& m, const Key& k, Value v) { m[k] = v; }
+    static std::optional<Value> find(Map& m, const Key& k) { return find_entry<Value>(m, k); }
+    static bool contains(Map& m, const Key& k) { return m.find(k) != m.end(); }
+    static void erase(Map& m, const Key& k) { m.erase(k); }
+    static void clear(Map& m) { m.clear(); }
+    static size_t capacity(Map& m) { return m.bucket_count(); }
     static void destroy(Map&) {}
 };
 
@@ -79,12 +310,36 @@ public:
 template <typename Key, typename Value>
 class AbslFlatHashMapWrapper {
 public:
-    using Map = absl::flat_hash_map<Key, Value>;
+    using Map = absl::flat_hash_map<Key, Value,
+        absl::container_internal::hash_default_hash<Key>,
+        absl::container_internal::hash_default_eq<Key>,
+        EntryAllocator<Key, Value>>;
     
-    static Map create(size_t capacity) { return Map(capacity); }
+    static Map create(size_t capacity) { return Map(sized_for_load(capacity, kSwissMaxLoad)); }
     static void insert(Map& m, const Key& k, Value v) { m[k] = v; }
     static Value lookup(Map& m, const Key& k) { return m.at(k); }
+    // absl hashes and compares absl::string_view, which is only an alias of
+    // std::string_view when absl was built for C++17
+    static Value lookup_view(Map& m, std::string_view k) {
+        return m.find(absl::string_view(k.data(), k.size()))->second;
+    }
+    static void update(Map& m, const Key& k, Value v) { m[k] = v; }
+    static std::optional<Value> find(Map& m, const Key& k) { return find_entry<Value>(m, k); }
+    static bool contains(Map& m, const Key& k) { return m.find(k) != m.end(); }
+    static void erase(Map& m, const Key& k) { m.erase(k); }
+    static void clear(Map& m) { m.clear(); }
+    static size_t capacity(Map& m) { return m.capacity(); }
     static void destroy(Map&) {}
+
+    // absl::raw_hash_set::prefetch hashes the key and prefetches its group
+    static void batch_lookup(Map& m, const Key* keys, size_t n, Value* out) {
+        pipelined<bool>(n, [&](size_t i) { m.prefetch(keys[i]); return true; },
+                        [&](size_t i, bool) { out[i] = m.find(keys[i])->second; });
+    }
+    static void batch_insert(Map& m, const Key* keys, size_t n, const Value* values) {
+        pipelined<bool>(n, [&](size_t i) { m.prefetch(keys[i]); return true; },
+                        [&](size_t i, bool) { m[keys[i]] = values[i]; });
+    }
 };
 
 // ============================================================================
@@ -93,12 +348,34 @@ public:
 template <typename Key, typename Value>
 class AbslNodeHashMapWrapper {
 public:
-    using Map = absl::node_hash_map<Key, Value>;
+    using Map = absl::node_hash_map<Key, Value,
+        absl::container_internal::hash_default_hash<Key>,
+        absl::container_internal::hash_default_eq<Key>,
+        EntryAllocator<Key, Value>>;
     
-    static Map create(size_t capacity) { return Map(capacity); }
+    static Map create(size_t capacity) { return Map(sized_for_load(capacity, kSwissMaxLoad)); }
     static void insert(Map& m, const Key& k, Value v) { m[k] = v; }
     static Value lookup(Map& m, const Key& k) { return m.at(k); }
+    static Value lookup_view(Map& m, std::string_view k) {
+        return m.find(absl::string_view(k.data(), k.size()))->second;
+    }
+    static void update(Map& m, const Key& k, Value v) { m[k] = v; }
+    static std::optional<Value> find(Map& m, const Key& k) { return find_entry<Value>(m, k); }
+    static bool contains(Map& m, const Key& k) { return m.find(k) != m.end(); }
+    static void erase(Map& m, const Key& k) { m.erase(k); }
+    static void clear(Map& m) { m.clear(); }
+    static size_t capacity(Map& m) { return m.capacity(); }
     static void destroy(Map&) {}
+
+    // absl::raw_hash_set::prefetch hashes the key and prefetches its group
+    static void batch_lookup(Map& m, const Key* keys, size_t n, Value* out) {
+        pipelined<bool>(n, [&](size_t i) { m.prefetch(keys[i]); return true; },
+                        [&](size_t i, bool) { out[i] = m.find(keys[i])->second; });
+    }
+    static void batch_insert(Map& m, const Key* keys, size_t n, const Value* values) {
+        pipelined<bool>(n, [&](size_t i) { m.prefetch(keys[i]); return true; },
+                        [&](size_t i, bool) { m[keys[i]] = values[i]; });
+    }
 };
 
 // ============================================================================
@@ -107,16 +384,44 @@ public:
 template <typename Key, typename Value>
 class FollyF14FastMapWrapper {
 public:
-    using Map = folly::F14FastMap<Key, Value>;
+    using Map = folly::F14FastMap<Key, Value,
+        folly::f14::DefaultHasher<Key>,
+        folly::f14::DefaultKeyEqual<Key>,
+        EntryAllocator<Key, Value>>;
     
     static Map create(size_t capacity) {
         Map m;
-        m.reserve(capacity);
+        m.reserve(sized_for_load(capacity, kF14MaxLoad));
         return m;
     }
     static void insert(Map& m, const Key& k, Value v) { m[k] = v; }
     static Value lookup(Map& m, const Key& k) { return m.at(k); }
+    static Value lookup_view(Map& m, std::string_view k) { return m.find(k)->second; }
+    static void update(Map& m, const Key& k, Value v) { m[k] = v; }
+    static std::optional<Value> find(Map& m, const Key& k) { return find_entry<Value>(m, k); }
+    static bool contains(Map& m, const Key& k) { return m.find(k) != m.end(); }
+    static void erase(Map& m, const Key& k) { m.erase(k); }
+    static void clear(Map& m) { m.clear(); }
+    static size_t capacity(Map& m) { return m.bucket_count(); }
     static void destroy(Map&) {}
+
+    // prehash() computes the hash and prefetches the first probed chunk; the
+    // token lets find() and try_emplace_token() skip rehashing
+    static void batch_lookup(Map& m, const Key* keys, size_t n, Value* out) {
+        using Token = decltype(m.prehash(keys[0]));
+        pipelined<Token>(n, [&](size_t i) { return m.prehash(keys[i]); },
+                         [&](size_t i, const Token& token) { out[i] = m.find(token, keys[i])->second; });
+    }
+    static void batch_insert(Map& m, const Key* keys, size_t n, const Value* values) {
+        using Token = decltype(m.prehash(keys[0]));
+        pipelined<Token>(n, [&](size_t i) { return m.prehash(keys[i]); },
+                         [&](size_t i, const Token& token) {
+                             auto [it, inserted] = m.try_emplace_token(token, keys[i], values[i]);
+                             if (!inserted) {
+                                 it->second = values[i];
+                             }
+                         });
+    }
 };
 
 // ============================================================================
@@ -139,6 +444,11 @@ public:
         auto it = m.find(k);
         return it->second;
     }
+    static void update(Map& m, const Key& k, Value v) { m[k] = v; }
+    static std::optional<Value> find(Map& m, const Key& k) { return find_entry<Value>(m, k); }
+    static bool contains(Map& m, const Key& k) { return m.find(k) != m.end(); }
+    static void erase(Map& m, const Key& k) { m.erase(k); }
+    static void clear(Map& m) { m.clear(); }
     static void destroy(Map&) {}
 };
 
@@ -148,7 +458,7 @@ public:
 template <typename Key, typename Value>
 class BoostFlatMapWrapper {
 public:
-    using Map = boost::container::flat_map<Key, Value>;
+    using Map = boost::container::flat_map<Key, Value, std::less<Key>, HugePageAllocator<std::pair<Key, Value>>>;
     static constexpr bool is_ordered = true;
     
     static Map create(size_t capacity) { 
@@ -163,6 +473,12 @@ public:
         auto it = m.find(k);
         return it->second;
     }
+    static void update(Map& m, const Key& k, Value v) { m[k] = v; }
+    static std::optional<Value> find(Map& m, const Key& k) { return find_entry<Value>(m, k); }
+    static bool contains(Map& m, const Key& k) { return m.find(k) != m.end(); }
+    static void erase(Map& m, const Key& k) { m.erase(k); }
+    static void clear(Map& m) { m.clear(); }
+    static size_t capacity(Map& m) { return m.capacity(); }
     static void destroy(Map&) {}
 };
 
@@ -172,15 +488,110 @@ public:
 template <typename Key, typename Value>
 class StdMapWrapper {
 public:
-    using Map = std::map<Key, Value>;
+    using Map = std::map<Key, Value, std::less<>>;
     static constexpr bool is_ordered = true;
     
     static Map create(size_t) { return Map(); }
     static void insert(Map& m, const Key& k, Value v) { m[k] = v; }
     static Value lookup(Map& m, const Key& k) { return m.at(k); }
+    static Value lookup_view(Map& m, std::string_view k) { return m.find(k)->second; }
+    static void update(Map& m, const Key& k, Value v) { m[k] = v; }
+    static std::optional<Value> find(Map& m, const Key& k) { return find_entry<Value>(m, k); }
+    static bool contains(Map& m, const Key& k) { return m.find(k) != m.end(); }
+    static void erase(Map& m, const Key& k) { m.erase(k); }
+    static void clear(Map& m) { m.clear(); }
     static void destroy(Map&) {}
 };
 
+// ============================================================================
+// Arena-backed node containers (std::pmr allocators)
+// Resource is std::pmr::monotonic_buffer_resource or SlabPoolResource; the
+// map owns it, so destroying the map also releases the arena
+// ============================================================================
+template <typename Key, typename Value, typename Resource>
+class StdUnorderedMapArenaWrapper {
+public:
+    using Map = ArenaMap<std::pmr::unordered_map<Key, Value, StdHash<Key>, StdKeyEqual<Key>>, Resource>;
+    static constexpr bool is_ordered = false;
+    
+    static Map create(size_t capacity) {
+        Map m;
+        if (target_load_factor > 0) {
+            m.map.max_load_factor(static_cast<float>(target_load_factor));
+        }
+        m.map.reserve(capacity);
+        return m;
+    }
+    static void insert(Map& m, const Key& k, Value v) { m.map[k] = v; }
+    static Value lookup(Map& m, const Key& k) { return m.map.at(k); }
+    static Value lookup_view(Map& m, std::string_view k) { return m.map.find(k)->second; }
+    static void update(Map& m, const Key& k, Value v) { m.map[k] = v; }
+    static std::optional<Value> find(Map& m, const Key& k) { return find_entry<Value>(m.map, k); }
+    static bool contains(Map& m, const Key& k) { return m.map.find(k) != m.map.end(); }
+    static void erase(Map& m, const Key& k) { m.map.erase(k); }
+    static void clear(Map& m) { m.map.clear(); }
+    static size_t capacity(Map& m) { return m.map.bucket_count(); }
+    static void destroy(Map&) {}
+};
+
+template <typename Key, typename Value, typename Resource>
+class AbslNodeHashMapArenaWrapper {
+public:
+    using Map = ArenaMap<absl::node_hash_map<Key, Value,
+        absl::container_internal::hash_default_hash<Key>,
+        absl::container_internal::hash_default_eq<Key>,
+        std::pmr::polymorphic_allocator<std::pair<const Key, Value>>>, Resource>;
+    
+    static Map create(size_t capacity) {
+        Map m;
+        m.map.reserve(sized_for_load(capacity, kSwissMaxLoad));
+        return m;
+    }
+    static void insert(Map& m, const Key& k, Value v) { m.map[k] = v; }
+    static Value lookup(Map& m, const Key& k) { return m.map.at(k); }
+    static Value lookup_view(Map& m, std::string_view k) {
+        return m.map.find(absl::string_view(k.data(), k.size()))->second;
+    }
+    static void update(Map& m, const Key& k, Value v) { m.map[k] = v; }
+    static std::optional<Value> find(Map& m, const Key& k) { return find_entry<Value>(m.map, k); }
+    static bool contains(Map& m, const Key& k) { return m.map.find(k) != m.map.end(); }
+    static void erase(Map& m, const Key& k) { m.map.erase(k); }
+    static void clear(Map& m) { m.map.clear(); }
+    static size_t capacity(Map& m) { return m.map.capacity(); }
+    static void destroy(Map&) {}
+};
+
+template <typename Key, typename Value, typename Resource>
+class StdMapArenaWrapper {
+public:
+    using Map = ArenaMap<std::pmr::map<Key, Value, std::less<>>, Resource>;
+    static constexpr bool is_ordered = true;
+    
+    static Map create(size_t) { return Map(); }
+    static void insert(Map& m, const Key& k, Value v) { m.map[k] = v; }
+    static Value lookup(Map& m, const Key& k) { return m.map.at(k); }
+    static Value lookup_view(Map& m, std::string_view k) { return m.map.find(k)->second; }
+    static void update(Map& m, const Key& k, Value v) { m.map[k] = v; }
+    static std::optional<Value> find(Map& m, const Key& k) { return find_entry<Value>(m.map, k); }
+    static bool contains(Map& m, const Key& k) { return m.map.find(k) != m.map.end(); }
+    static void erase(Map& m, const Key& k) { m.map.erase(k); }
+    static void clear(Map& m) { m.map.clear(); }
+    static void destroy(Map&) {}
+};
+
+template <typename Key, typename Value>
+using StdUnorderedMapMonotonicWrapper = StdUnorderedMapArenaWrapper<Key, Value, std::pmr::monotonic_buffer_resource>;
+template <typename Key, typename Value>
+using StdUnorderedMapSlabWrapper = StdUnorderedMapArenaWrapper<Key, Value, SlabPoolResource>;
+template <typename Key, typename Value>
+using AbslNodeHashMapMonotonicWrapper = AbslNodeHashMapArenaWrapper<Key, Value, std::pmr::monotonic_buffer_resource>;
+template <typename Key, typename Value>
+using AbslNodeHashMapSlabWrapper = AbslNodeHashMapArenaWrapper<Key, Value, SlabPoolResource>;
+template <typename Key, typename Value>
+using StdMapMonotonicWrapper = StdMapArenaWrapper<Key, Value, std::pmr::monotonic_buffer_resource>;
+template <typename Key, typename Value>
+using StdMapSlabWrapper = StdMapArenaWrapper<Key, Value, SlabPoolResource>;
+
 // ============================================================================
 // absl::btree_map wrapper (ordered)
 // ============================================================================
@@ -193,6 +604,14 @@ public:
     static Map create(size_t) { return Map(); }
     static void insert(Map& m, const Key& k, Value v) { m[k] = v; }
     static Value lookup(Map& m, const Key& k) { return m.at(k); }
+    static Value lookup_view(Map& m, std::string_view k) {
+        return m.find(absl::string_view(k.data(), k.size()))->second;
+    }
+    static void update(Map& m, const Key& k, Value v) { m[k] = v; }
+    static std::optional<Value> find(Map& m, const Key& k) { return find_entry<Value>(m, k); }
+    static bool contains(Map& m, const Key& k) { return m.find(k) != m.end(); }
+    static void erase(Map& m, const Key& k) { m.erase(k); }
+    static void clear(Map& m) { m.clear(); }
     static void destroy(Map&) {}
 };
 
@@ -202,7 +621,7 @@ public:
 template <typename Key, typename Value>
 class FollySortedVectorMapWrapper {
 public:
-    using Map = folly::sorted_vector_map<Key, Value>;
+    using Map = folly::sorted_vector_map<Key, Value, std::less<Key>, HugePageAllocator<std::pair<Key, Value>>>;
     static constexpr bool is_ordered = true;
     
     static Map create(size_t capacity) { 
@@ -217,6 +636,12 @@ public:
         auto it = m.find(k);
         return it->second;
     }
+    static void update(Map& m, const Key& k, Value v) { m[k] = v; }
+    static std::optional<Value> find(Map& m, const Key& k) { return find_entry<Value>(m, k); }
+    static bool contains(Map& m, const Key& k) { return m.find(k) != m.end(); }
+    static void erase(Map& m, const Key& k) { m.erase(k); }
+    static void clear(Map& m) { m.clear(); }
+    static size_t capacity(Map& m) { return m.capacity(); }
     static void destroy(Map&) {}
 };
 
@@ -229,7 +654,8 @@ public:
     using Map = google::dense_hash_map<Key, Value>;
     
     static Map create(size_t capacity) { 
-        Map m(capacity);
+        // Sized after the grow threshold is set; resize() never shrinks
+        Map m(target_load_factor > 0 ? 0 : capacity);
         if constexpr (std::is_same_v<Key, std::string>) {
             m.set_empty_key("\x00");
             m.set_deleted_key("\xff");
@@ -240,10 +666,20 @@ public:
             m.set_empty_key(~0ULL);
             m.set_deleted_key(~0ULL - 1);
         }
+        if (target_load_factor > 0) {
+            m.set_resizing_parameters(0.2f, static_cast<float>(target_load_factor));
+            m.resize(capacity);
+        }
         return m;
     }
     static void insert(Map& m, const Key& k, Value v) { m[k] = v; }
-    static Value lookup(Map& m, const Key& k) { return m[k]; }
+    static Value lookup(Map& m, const Key& k) { return m.find(k)->second; }
+    static void update(Map& m, const Key& k, Value v) { m[k] = v; }
+    static std::optional<Value> find(Map& m, const Key& k) { return find_entry<Value>(m, k); }
+    static bool contains(Map& m, const Key& k) { return m.find(k) != m.end(); }
+    static void erase(Map& m, const Key& k) { m.erase(k); }
+    static void clear(Map& m) { m.clear(); }
+    static size_t capacity(Map& m) { return m.bucket_count(); }
     static void destroy(Map&) {}
 };
 
@@ -256,7 +692,8 @@ public:
     using Map = google::sparse_hash_map<Key, Value>;
     
     static Map create(size_t capacity) { 
-        Map m(capacity);
+        // Sized after the grow threshold is set; resize() never shrinks
+        Map m(target_load_factor > 0 ? 0 : capacity);
         if constexpr (std::is_same_v<Key, std::string>) {
             m.set_deleted_key("\xff");
         } else if constexpr (std::is_same_v<Key, uint32_t>) {
@@ -264,10 +701,20 @@ public:
         } else if constexpr (std::is_same_v<Key, uint64_t>) {
             m.set_deleted_key(~0ULL);
         }
+        if (target_load_factor > 0) {
+            m.set_resizing_parameters(0.2f, static_cast<float>(target_load_factor));
+            m.resize(capacity);
+        }
         return m;
     }
     static void insert(Map& m, const Key& k, Value v) { m[k] = v; }
-    static Value lookup(Map& m, const Key& k) { return m[k]; }
+    static Value lookup(Map& m, const Key& k) { return m.find(k)->second; }
+    static void update(Map& m, const Key& k, Value v) { m[k] = v; }
+    static std::optional<Value> find(Map& m, const Key& k) { return find_entry<Value>(m, k); }
+    static bool contains(Map& m, const Key& k) { return m.find(k) != m.end(); }
+    static void erase(Map& m, const Key& k) { m.erase(k); }
+    static void clear(Map& m) { m.clear(); }
+    static size_t capacity(Map& m) { return m.bucket_count(); }
     static void destroy(Map&) {}
 };
 
@@ -277,11 +724,24 @@ public:
 template <typename Key, typename Value>
 class CuckooHashMapWrapper {
 public:
-    using Map = libcuckoo::cuckoohash_map<Key, Value>;
+    using Map = libcuckoo::cuckoohash_map<Key, Value, std::hash<Key>, std::equal_to<Key>, EntryAllocator<Key, Value>>;
+    static constexpr bool is_concurrent = true;
     
-    static Map create(size_t capacity) { return Map(capacity); }
+    static Map create(size_t capacity) { return Map(sized_for_load(capacity, 1.0)); }
     static void insert(Map& m, const Key& k, Value v) { m.insert(k, v); }
     static Value lookup(Map& m, const Key& k) { return m.find(k); }
+    static std::optional<Value> find(Map& m, const Key& k) {
+        Value v;
+        if (!m.find(k, v)) {
+            return std::nullopt;
+        }
+        return v;
+    }
+    static void update(Map& m, const Key& k, Value v) { m.insert_or_assign(k, v); }
+    static bool contains(Map& m, const Key& k) { return m.contains(k); }
+    static void erase(Map& m, const Key& k) { m.erase(k); }
+    static void clear(Map& m) { m.clear(); }
+    static size_t capacity(Map& m) { return m.bucket_count(); }
     static void destroy(Map&) {}
 };
 
@@ -293,7 +753,7 @@ public:
     using Map = rhashmap_t*;
     
     static Map create(size_t capacity) { 
-        return rhashmap_create(capacity, RHM_NONCRYPTO);
+        return rhashmap_create(std::max(capacity, kMinCreateCapacity), RHM_NONCRYPTO);
     }
     static void insert(Map& m, const std::string& k, uint64_t v) { 
         rhashmap_put(m, k.c_str(), k.length(), reinterpret_cast<void*>(v));
@@ -302,6 +762,28 @@ public:
         void* val = rhashmap_get(m, k.c_str(), k.length());
         return reinterpret_cast<uint64_t>(val);
     }
+    static uint64_t lookup_view(Map& m, std::string_view k) {
+        return reinterpret_cast<uint64_t>(rhashmap_get(m, k.data(), k.size()));
+    }
+    // rhashmap_put keeps an existing value, so replace the entry
+    static void update(Map& m, const std::string& k, uint64_t v) {
+        rhashmap_del(m, k.c_str(), k.length());
+        insert(m, k, v);
+    }
+    // A stored value of 0 reads back as NULL, i.e. as a miss
+    static std::optional<uint64_t> find(Map& m, const std::string& k) {
+        void* val = rhashmap_get(m, k.c_str(), k.length());
+        if (val == nullptr) {
+            return std::nullopt;
+        }
+        return reinterpret_cast<uint64_t>(val);
+    }
+    static bool contains(Map& m, const std::string& k) {
+        return rhashmap_get(m, k.c_str(), k.length()) != nullptr;
+    }
+    static void erase(Map& m, const std::string& k) {
+        rhashmap_del(m, k.c_str(), k.length());
+    }
     static void destroy(Map& m) { rhashmap_destroy(m); }
 };
 
@@ -311,16 +793,37 @@ public:
 template <typename Key, typename Value>
 class PhmapFlatHashMapWrapper {
 public:
-    using Map = phmap::flat_hash_map<Key, Value>;
+    using Map = phmap::flat_hash_map<Key, Value,
+        phmap::priv::hash_default_hash<Key>,
+        phmap::priv::hash_default_eq<Key>,
+        EntryAllocator<Key, Value>>;
 
     static Map create(size_t capacity) {
         Map m;
-        m.reserve(capacity);
+        m.reserve(sized_for_load(capacity, kSwissMaxLoad));
         return m;
     }
     static void insert(Map& m, const Key& k, Value v) { m[k] = v; }
     static Value lookup(Map& m, const Key& k) { return m.at(k); }
+    static Value lookup_view(Map& m, std::string_view k) { return m.find(k)->second; }
+    static void update(Map& m, const Key& k, Value v) { m[k] = v; }
+    static std::optional<Value> find(Map& m, const Key& k) { return find_entry<Value>(m, k); }
+    static bool contains(Map& m, const Key& k) { return m.find(k) != m.end(); }
+    static void erase(Map& m, const Key& k) { m.erase(k); }
+    static void clear(Map& m) { m.clear(); }
+    static size_t capacity(Map& m) { return m.bucket_count(); }
     static void destroy(Map&) {}
+
+    // Hash once, prefetch_hash() the probe group, then find(key, hash) or
+    // try_emplace_with_hash(hash, key)
+    static void batch_lookup(Map& m, const Key* keys, size_t n, Value* out) {
+        pipelined<size_t>(n, [&](size_t i) { size_t h = m.hash(keys[i]); m.prefetch_hash(h); return h; },
+                          [&](size_t i, size_t h) { out[i] = m.find(keys[i], h)->second; });
+    }
+    static void batch_insert(Map& m, const Key* keys, size_t n, const Value* values) {
+        pipelined<size_t>(n, [&](size_t i) { size_t h = m.hash(keys[i]); m.prefetch_hash(h); return h; },
+                          [&](size_t i, size_t h) { m.try_emplace_with_hash(h, keys[i]).first->second = values[i]; });
+    }
 };
 
 // ============================================================================
@@ -329,15 +832,77 @@ public:
 template <typename Key, typename Value>
 class PhmapParallelHashMapWrapper {
 public:
-    using Map = phmap::parallel_flat_hash_map<Key, Value>;
+    using Map = phmap::parallel_flat_hash_map<Key, Value,
+        phmap::priv::hash_default_hash<Key>,
+        phmap::priv::hash_default_eq<Key>,
+        EntryAllocator<Key, Value>>;
 
     static Map create(size_t capacity) {
         Map m;
-        m.reserve(capacity);
+        m.reserve(sized_for_load(capacity, kSwissMaxLoad));
         return m;
     }
     static void insert(Map& m, const Key& k, Value v) { m[k] = v; }
     static Value lookup(Map& m, const Key& k) { return m.at(k); }
+    static Value lookup_view(Map& m, std::string_view k) { return m.find(k)->second; }
+    static void update(Map& m, const Key& k, Value v) { m[k] = v; }
+    static std::optional<Value> find(Map& m, const Key& k) { return find_entry<Value>(m, k); }
+    static bool contains(Map& m, const Key& k) { return m.find(k) != m.end(); }
+    static void erase(Map& m, const Key& k) { m.erase(k); }
+    static void clear(Map& m) { m.clear(); }
+    static size_t capacity(Map& m) { return m.bucket_count(); }
+    static void destroy(Map&) {}
+
+    static void batch_lookup(Map& m, const Key* keys, size_t n, Value* out) {
+        pipelined<size_t>(n, [&](size_t i) { size_t h = m.hash(keys[i]); m.prefetch_hash(h); return h; },
+                          [&](size_t i, size_t h) { out[i] = m.find(keys[i], h)->second; });
+    }
+    static void batch_insert(Map& m, const Key* keys, size_t n, const Value* values) {
+        pipelined<size_t>(n, [&](size_t i) { size_t h = m.hash(keys[i]); m.prefetch_hash(h); return h; },
+                          [&](size_t i, size_t h) { m.try_emplace_with_hash(h, keys[i]).first->second = values[i]; });
+    }
+};
+
+// ============================================================================
+// phmap::parallel_flat_hash_map wrapper with per-submap std::mutex
+// Thread-safe variant used by the concurrent (-t) mode
+// ============================================================================
+template <typename Key, typename Value>
+class PhmapParallelHashMapMtWrapper {
+public:
+    using Map = phmap::parallel_flat_hash_map<
+        Key, Value,
+        phmap::priv::hash_default_hash<Key>,
+        phmap::priv::hash_default_eq<Key>,
+        EntryAllocator<Key, Value>,
+        4, std::mutex>;
+    static constexpr bool is_concurrent = true;
+
+    static Map create(size_t capacity) {
+        Map m;
+        m.reserve(capacity);
+        return m;
+    }
+    static void insert(Map& m, const Key& k, Value v) {
+        // operator[] would hand back a reference after the submap lock is released
+        m.try_emplace_l(k, [v](auto& kv) { kv.second = v; }, v);
+    }
+    static Value lookup(Map& m, const Key& k) {
+        Value v{};
+        m.if_contains(k, [&v](const auto& kv) { v = kv.second; });
+        return v;
+    }
+    static void update(Map& m, const Key& k, Value v) { insert(m, k, v); }
+    static std::optional<Value> find(Map& m, const Key& k) {
+        std::optional<Value> v;
+        m.if_contains(k, [&v](const auto& kv) { v = kv.second; });
+        return v;
+    }
+    static bool contains(Map& m, const Key& k) {
+        return m.if_contains(k, [](const auto&) {});
+    }
+    static void erase(Map& m, const Key& k) { m.erase(k); }
+    static void clear(Map& m) { m.clear(); }
     static void destroy(Map&) {}
 };
 
@@ -356,19 +921,36 @@ public:
     static Map create(size_t capacity) {
         Context* ctx = new Context();
         ctx->heap = OPHeapOpenTmp();
-        ctx->table = HTNew(ctx->heap, capacity, 0.95, sizeof(uint64_t), sizeof(uint64_t));
+        ctx->table = HTNew(ctx->heap, std::max(capacity, kMinCreateCapacity),
+                           target_load_factor > 0 ? target_load_factor : 0.95, sizeof(uint64_t), sizeof(uint64_t));
         return ctx;
     }
     static void insert(Map& ctx, uint64_t k, uint64_t v) {
         bool is_dup = false;
-        HTUpsertCustom(ctx->table, OPDefaultHash, &k,
-                       reinterpret_cast<void**>(&v), &is_dup);
+        void* slot = nullptr;
+        HTUpsertCustom(ctx->table, OPDefaultHash, &k, &slot, &is_dup);
+        std::memcpy(slot, &v, sizeof(v));
     }
     static uint64_t lookup(Map& ctx, uint64_t k) {
         uint64_t* val = reinterpret_cast<uint64_t*>(
             HTGetCustom(ctx->table, OPDefaultHash, &k));
         return val ? *val : 0;
     }
+    static void update(Map& ctx, uint64_t k, uint64_t v) { insert(ctx, k, v); }
+    static std::optional<uint64_t> find(Map& ctx, uint64_t k) {
+        uint64_t* val = reinterpret_cast<uint64_t*>(
+            HTGetCustom(ctx->table, OPDefaultHash, &k));
+        if (val == nullptr) {
+            return std::nullopt;
+        }
+        return *val;
+    }
+    static bool contains(Map& ctx, uint64_t k) {
+        return HTGetCustom(ctx->table, OPDefaultHash, &k) != nullptr;
+    }
+    static void erase(Map& ctx, uint64_t k) {
+        HTDelCustom(ctx->table, OPDefaultHash, &k);
+    }
     static void destroy(Map& ctx) {
         HTDestroy(ctx->table);
         OPHeapClose(ctx->heap);
@@ -380,21 +962,55 @@ public:
 // CLHT wrappers (Lock-Based and Lock-Free hash tables)
 // Only supports integer keys (uintptr_t)
 // ============================================================================
+// Buckets for capacity keys: the sweep's target occupancy, else -c
+inline size_t clht_buckets(size_t capacity) {
+    if (target_load_factor > 0) {
+        return static_cast<size_t>(static_cast<double>(capacity) / (target_load_factor * kClhtSlotsPerBucket));
+    }
+    return capacity * clht_capacity_factor / kClhtSlotsPerBucket;
+}
+
 class ClhtLbWrapper {
 public:
     using Map = clht_t*;
+    static constexpr bool is_concurrent = true;
     
     static Map create(size_t capacity) {
-        clht_t* ht = clht_create(capacity);
+        clht_t* ht = clht_create(std::max(clht_buckets(capacity), kMinCreateCapacity));
         clht_gc_thread_init(ht, 0);
         return ht;
     }
+    // Every thread touching the table needs its own ssmem allocator and a
+    // thread id distinct from the others; create() takes id 0
+    static void thread_init(Map& ht, int thread_id) {
+        clht_gc_thread_init(ht, thread_id);
+    }
     static void insert(Map& ht, uint64_t k, uint64_t v) {
         clht_put(ht, (clht_addr_t)k, (clht_val_t)v);
     }
     static uint64_t lookup(Map& ht, uint64_t k) {
         return (uint64_t)clht_get(ht->ht, (clht_addr_t)k);
     }
+    // clht_put never overwrites an existing key
+    static void update(Map& ht, uint64_t k, uint64_t v) {
+        clht_remove(ht, (clht_addr_t)k);
+        clht_put(ht, (clht_addr_t)k, (clht_val_t)v);
+    }
+    // CLHT reports a miss as value 0
+    static std::optional<uint64_t> find(Map& ht, uint64_t k) {
+        clht_val_t val = clht_get(ht->ht, (clht_addr_t)k);
+        if (val == 0) {
+            return std::nullopt;
+        }
+        return (uint64_t)val;
+    }
+    static bool contains(Map& ht, uint64_t k) {
+        return clht_get(ht->ht, (clht_addr_t)k) != 0;
+    }
+    static void erase(Map& ht, uint64_t k) {
+        clht_remove(ht, (clht_addr_t)k);
+    }
+    static size_t capacity(Map& ht) { return ht->ht->num_buckets * kClhtSlotsPerBucket; }
     static void destroy(Map& ht) {
         clht_gc_destroy(ht);
     }
@@ -403,18 +1019,44 @@ public:
 class ClhtLfWrapper {
 public:
     using Map = clht_t*;
+    static constexpr bool is_concurrent = true;
     
     static Map create(size_t capacity) {
-        clht_t* ht = clht_create(capacity);
+        clht_t* ht = clht_create(std::max(clht_buckets(capacity), kMinCreateCapacity));
         clht_gc_thread_init(ht, 0);
         return ht;
     }
+    // Every thread touching the table needs its own ssmem allocator and a
+    // thread id distinct from the others; create() takes id 0
+    static void thread_init(Map& ht, int thread_id) {
+        clht_gc_thread_init(ht, thread_id);
+    }
     static void insert(Map& ht, uint64_t k, uint64_t v) {
         clht_put(ht, (clht_addr_t)k, (clht_val_t)v);
     }
     static uint64_t lookup(Map& ht, uint64_t k) {
         return (uint64_t)clht_get(ht->ht, (clht_addr_t)k);
     }
+    // clht_put never overwrites an existing key
+    static void update(Map& ht, uint64_t k, uint64_t v) {
+        clht_remove(ht, (clht_addr_t)k);
+        clht_put(ht, (clht_addr_t)k, (clht_val_t)v);
+    }
+    // CLHT reports a miss as value 0
+    static std::optional<uint64_t> find(Map& ht, uint64_t k) {
+        clht_val_t val = clht_get(ht->ht, (clht_addr_t)k);
+        if (val == 0) {
+            return std::nullopt;
+        }
+        return (uint64_t)val;
+    }
+    static bool contains(Map& ht, uint64_t k) {
+        return clht_get(ht->ht, (clht_addr_t)k) != 0;
+    }
+    static void erase(Map& ht, uint64_t k) {
+        clht_remove(ht, (clht_addr_t)k);
+    }
+    static size_t capacity(Map& ht) { return ht->ht->num_buckets * kClhtSlotsPerBucket; }
     static void destroy(Map& ht) {
         clht_gc_destroy(ht);
     }
@@ -13,8 +13,18 @@
  *   - boost::container::flat_map
  */
 
+#include <algorithm>
+#include <barrier>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 #include <cstring>
 #include <getopt.h>
@@ -27,7 +37,14 @@
 
 // Benchmark framework
 #include "benchmark.hpp"
+#include "compare.hpp"
 #include "hash_maps.hpp"
+#include "hugepages.hpp"
+#include "key_corpus.hpp"
+#include "memory_tracker.hpp"
+#include "numa.hpp"
+#include "registry.hpp"
+#include "trace.hpp"
 
 // Logging disabled for cleaner output
 #define LOG_DEBUG(fmt, ...) ((void)0)
@@ -36,13 +53,314 @@
 using namespace hashmap_bench;
 
 template <typename T, typename = void>
-struct has_batch_insert : std::false_type {};
+struct has_thread_init : std::false_type {};
 
 template <typename T>
-struct has_batch_insert<T, std::void_t<decltype(T::batch_insert(
-    std::declval<typename T::Map&>(),
-    std::declval<const std::vector<std::string>&>(),
-    std::declval<const std::vector<uint64_t>&>()))>> : std::true_type {};
+struct has_thread_init<T, std::void_t<decltype(T::thread_init(
+    std::declval<typename T::Map&>(), 0))>> : std::true_type {};
+
+// Worker threads for the concurrent mode (-t); 1 runs the single-threaded suite
+static int num_threads = 1;
+
+// Time every Nth insert/lookup into a latency histogram (-l); 0 disables sampling
+static uint64_t latency_sample_every = 0;
+
+// Seed for every randomized stream (-s)
+static uint64_t seed = 1;
+
+// Mixed workload (-w); while current_workload holds operations, the key
+// benchmarks replay it instead of the insert-all/lookup-all phases
+static bool workload_enabled = false;
+static WorkloadMix workload_mix;
+static Workload current_workload;
+
+// Query-phase access distribution (-d); query_order holds the key indices the
+// lookup phase walks, empty for sequential insertion order
+static AccessDistribution access_distribution;
+static std::vector<uint32_t> query_order;
+
+// Keys absent from the current key set, looked up in the miss phase
+static std::vector<std::string> string_miss_keys;
+
+// The current string keys packed into one buffer. By default the std::string
+// keys are rebuilt from it, and wrappers with a transparent lookup query
+// views into it; --scattered-keys keeps the generated std::string vector and
+// leaves the store empty unless --view-lookup needs it
+static KeyStore string_key_store;
+static bool scattered_keys = false;
+static std::vector<uint64_t> int_miss_keys;
+
+// Hardware counters around each single-threaded phase (--perf); null when off
+static std::unique_ptr<PerfCounters> perf_counters;
+
+// Implementations to run (-i): comma-separated names or globs, empty for all
+static std::string impl_filter;
+
+// Keys per lookup_batch / insert_batch call (--batch); 0 skips the batched phases
+static uint32_t batch_size = 0;
+
+// Node whose CPUs repeat the query phase against the map built on the home
+// CPUs (--query-node); -1 skips the remote phase
+static int query_node = -1;
+static std::vector<int> home_cpus;
+
+// Target occupancies of --load-factor-sweep; empty runs the suite once
+static std::vector<double> load_factors;
+
+// Shape of the parametric str:LEN keys (--key-alphabet, --key-prefix)
+static KeySpec key_shape;
+
+// Keys mapped from --keys-file, and how many of them each run takes; 0 when
+// the keys are generated
+static KeyCorpus key_corpus;
+static size_t corpus_keys = 0;
+static const char* const kFileKeyType = "file";
+static const char* const kIntFileKeyType = "file-int";
+
+// Operation trace replayed through every wrapper (--trace); its keys and
+// decoded Workload replace the generated ones
+static Trace replay_trace;
+static bool trace_loaded = false;
+static const char* const kTraceKeyType = "trace";
+static const char* const kIntTraceKeyType = "trace-int";
+
+// Repeat the string query phase with std::string_view keys (--view-lookup)
+static bool view_lookup = false;
+
+// ============================================================================
+// Timed phases with optional per-operation latency sampling
+// ============================================================================
+
+// Counters are enabled before the phase timer starts and read after it stops
+inline void perf_start() {
+    if (perf_counters) {
+        perf_counters->start();
+    }
+}
+
+inline PerfCounts perf_stop(uint64_t ops) {
+    return perf_counters ? perf_counters->stop().per_op(ops) : PerfCounts{};
+}
+
+template <typename Wrapper, typename Key>
+void insert_keys(typename Wrapper::Map& map, const std::vector<Key>& keys, LatencyHistogram* hist) {
+    if (hist == nullptr) {
+        for (const auto& key : keys) {
+            Wrapper::insert(map, key, uint64_t{0});
+        }
+        return;
+    }
+    uint64_t countdown = latency_sample_every;
+    for (const auto& key : keys) {
+        if (--countdown == 0) {
+            countdown = latency_sample_every;
+            uint64_t start = Clock::now();
+            Wrapper::insert(map, key, uint64_t{0});
+            hist->record(sample_ticks(start));
+        } else {
+            Wrapper::insert(map, key, uint64_t{0});
+        }
+    }
+}
+
+// Resize trace under --no-reserve: every insert is timed so the ones that
+// changed the wrapper's capacity() can be reported as resizes
+template <typename Wrapper, typename Key>
+void insert_keys_traced(typename Wrapper::Map& map, const std::vector<Key>& keys,
+                        std::vector<RehashEvent>& events) {
+    size_t capacity = Wrapper::capacity(map);
+    for (size_t i = 0; i < keys.size(); i++) {
+        uint64_t start = Clock::now();
+        Wrapper::insert(map, keys[i], uint64_t{0});
+        uint64_t ticks = sample_ticks(start);
+        size_t grown = Wrapper::capacity(map);
+        if (grown != capacity) {
+            events.push_back({i, capacity, grown, Clock::ticks_to_sec(ticks)});
+            capacity = grown;
+        }
+    }
+}
+
+// Insert phase of the single-threaded benchmarks; the same untraced loop for
+// every wrapper, the resize trace runs separately in trace_growth()
+template <typename Wrapper, typename Key>
+void insert_phase(typename Wrapper::Map& map, const std::vector<Key>& keys, LatencyHistogram* hist,
+                  BenchmarkResult& result) {
+    result.reserved = reserve_capacity;
+    insert_keys<Wrapper>(map, keys, hist);
+    if constexpr (has_capacity<Wrapper>::value) {
+        size_t capacity = Wrapper::capacity(map);
+        result.occupancy = capacity > 0 ? static_cast<double>(keys.size()) / capacity : 0;
+    }
+    result.load_factor = target_load_factor;
+}
+
+// Under --no-reserve, replay the inserts into a second empty map with a clock
+// read around each one, so the measured pass above stays free of them
+template <typename Wrapper, typename Key>
+void trace_growth(const std::vector<Key>& keys, BenchmarkResult& result) {
+    if constexpr (has_capacity<Wrapper>::value) {
+        if (reserve_capacity) {
+            return;
+        }
+        auto map = Wrapper::create(initial_capacity(keys.size()));
+        Timer timer;
+        insert_keys_traced<Wrapper>(map, keys, result.rehash_events);
+        result.traced_insert_time_sec = timer.elapsed();
+        result.capacity_traced = true;
+        Wrapper::destroy(map);
+    }
+}
+
+template <typename Wrapper, typename Map, typename KeyAt>
+uint64_t lookup_loop(Map& map, size_t count, KeyAt key_at, LatencyHistogram* hist) {
+    uint64_t sum = 0;
+    if (hist == nullptr) {
+        for (size_t i = 0; i < count; i++) {
+            sum += Wrapper::lookup(map, key_at(i));
+        }
+        return sum;
+    }
+    uint64_t countdown = latency_sample_every;
+    for (size_t i = 0; i < count; i++) {
+        if (--countdown == 0) {
+            countdown = latency_sample_every;
+            uint64_t start = Clock::now();
+            sum += Wrapper::lookup(map, key_at(i));
+            hist->record(sample_ticks(start));
+        } else {
+            sum += Wrapper::lookup(map, key_at(i));
+        }
+    }
+    return sum;
+}
+
+// Look up every key once, in insertion order or in query_order (-d). Keys is
+// a std::vector or a KeyStore, whose elements are views returned by value.
+template <typename Wrapper, typename Keys>
+uint64_t lookup_keys(typename Wrapper::Map& map, const Keys& keys, LatencyHistogram* hist) {
+    if (query_order.empty()) {
+        return lookup_loop<Wrapper>(map, keys.size(),
+            [&keys](size_t i) -> decltype(auto) { return keys[i]; }, hist);
+    }
+    return lookup_loop<Wrapper>(map, query_order.size(),
+        [&keys](size_t i) -> decltype(auto) { return keys[query_order[i]]; }, hist);
+}
+
+// Looks keys up through lookup_by_view(), so lookup_keys() can walk a
+// KeyStore or a vector of std::string_view
+template <typename Wrapper>
+struct ViewLookup : Wrapper {
+    static uint64_t lookup(typename Wrapper::Map& m, std::string_view k) {
+        return lookup_by_view<Wrapper>(m, k);
+    }
+};
+
+// Whether the string keys come from string_key_store (the default); the same
+// for every wrapper, so one table never mixes two key sources
+template <typename Key>
+bool queries_key_store(const std::vector<Key>& keys) {
+    if constexpr (std::is_same_v<Key, std::string>) {
+        return !scattered_keys && string_key_store.size() >= keys.size();
+    } else {
+        return false;
+    }
+}
+
+// Query phase. From the key store, wrappers with a transparent lookup probe
+// views into it and the others the std::string keys rebuilt from it, so no
+// probe constructs a string. --scattered-keys walks the generated keys.
+template <typename Wrapper, typename Key>
+uint64_t query_keys(typename Wrapper::Map& map, const std::vector<Key>& keys, LatencyHistogram* hist) {
+    if constexpr (std::is_same_v<Key, std::string> && has_lookup_view<Wrapper>::value) {
+        if (queries_key_store(keys)) {
+            // A --load-factor-sweep point may query a prefix of the store
+            if (query_order.empty()) {
+                return lookup_loop<ViewLookup<Wrapper>>(map, keys.size(),
+                    [](size_t i) { return string_key_store[i]; }, hist);
+            }
+            return lookup_keys<ViewLookup<Wrapper>>(map, string_key_store, hist);
+        }
+    }
+    return lookup_keys<Wrapper>(map, keys, hist);
+}
+
+// Look up the first count keys that were never inserted; returns how many
+// were (wrongly) found
+template <typename Wrapper, typename Key>
+uint64_t lookup_misses(typename Wrapper::Map& map, const std::vector<Key>& misses, size_t count) {
+    uint64_t found = 0;
+    for (size_t i = 0; i < count; i++) {
+        found += Wrapper::find(map, misses[i]).has_value();
+    }
+    return found;
+}
+
+// Remote phase (--query-node): the map's pages were faulted in from the home
+// CPUs (or placed by --mem-node / --interleave); walk the query phase again
+// from query_node's CPUs. If the thread cannot move there the phase is
+// skipped and query_node stays -1, rather than reporting a local run as remote.
+template <typename Wrapper, typename Key>
+void benchmark_remote_query(typename Wrapper::Map& map, const std::vector<Key>& keys, BenchmarkResult& result) {
+    if (!numa_run_on_node(query_node)) {
+        std::cerr << "Warning: cannot run on NUMA node " << query_node << "; skipping the remote query of "
+                  << result.impl_name << "\n";
+        return;
+    }
+    result.query_node = query_node;
+    Timer timer;
+    side_effect += query_keys<Wrapper>(map, keys, nullptr);
+    result.remote_query_time_sec = timer.elapsed();
+    numa_run_on_cpus(home_cpus);
+}
+
+// Batched phases (--batch): look every key up again in groups of batch_size,
+// then fill a fresh map the same way, for comparison with the scalar phases.
+// values holds batch_size entries.
+template <typename Wrapper, typename Key>
+void benchmark_batched(typename Wrapper::Map& map, const std::vector<Key>& keys, std::vector<uint64_t>& values,
+                       BenchmarkResult& result) {
+    result.batch_size = batch_size;
+    result.batch_pipelined = has_batch_lookup<Wrapper, Key, uint64_t>::value;
+    
+    Timer timer;
+    for (size_t i = 0; i < keys.size(); i += batch_size) {
+        size_t n = std::min<size_t>(batch_size, keys.size() - i);
+        lookup_batch<Wrapper>(map, keys.data() + i, n, values.data());
+        for (size_t j = 0; j < n; j++) {
+            side_effect += values[j];
+        }
+    }
+    result.batch_query_time_sec = timer.elapsed();
+    
+    std::fill(values.begin(), values.end(), 0);
+    auto batch_map = Wrapper::create(initial_capacity(keys.size()));
+    timer.reset();
+    for (size_t i = 0; i < keys.size(); i += batch_size) {
+        size_t n = std::min<size_t>(batch_size, keys.size() - i);
+        insert_batch<Wrapper>(batch_map, keys.data() + i, n, values.data());
+    }
+    result.batch_insert_time_sec = timer.elapsed();
+    Wrapper::destroy(batch_map);
+}
+
+// View phase (--view-lookup): the keys are looked up again through views
+// into one buffer, as they would arrive in a request. Wrappers without a
+// transparent lookup pay a std::string construction per key.
+template <typename Wrapper>
+void benchmark_view_query(typename Wrapper::Map& map, const std::vector<std::string>& keys,
+                          BenchmarkResult& result) {
+    KeyStore packed;
+    if (string_key_store.size() != keys.size()) {
+        packed.assign(keys);
+    }
+    const KeyStore& store = packed.empty() ? string_key_store : packed;
+    
+    result.view_transparent = has_lookup_view<Wrapper>::value;
+    Timer timer;
+    side_effect += lookup_keys<ViewLookup<Wrapper>>(map, store, nullptr);
+    result.view_query_time_sec = timer.elapsed();
+}
 
 // ============================================================================
 // String key benchmarks
@@ -57,6 +375,11 @@ BenchmarkResult benchmark_string_keys(
     
     using Map = typename Wrapper::Map;
     
+    if (!current_workload.ops.empty()) {
+        return WorkloadBenchmark<Wrapper>::run(
+            impl_name, key_type, keys, current_workload, latency_sample_every, comments);
+    }
+    
     LOG_INFO("Benchmarking %s with %s keys (%zu elements)...", 
              impl_name.c_str(), key_type.c_str(), keys.size());
     
@@ -65,23 +388,35 @@ BenchmarkResult benchmark_string_keys(
     result.key_type = key_type;
     result.num_elements = keys.size();
     result.comments = comments;
+    if (!query_order.empty()) {
+        result.access_pattern = describe_access_distribution(access_distribution);
+    }
+    
+    // Allocated up front, outside the timed phases
+    LatencyHistogram insert_hist;
+    LatencyHistogram query_hist;
+    bool sampling = latency_sample_every > 0;
+    std::vector<uint64_t> batch_values(batch_size, 0);
     
     // Create map
     LOG_DEBUG("Creating map...");
-    Map map = Wrapper::create(keys.size());
+    size_t base_huge_bytes = hugepage_mode() != HugePageMode::Off ? hugepage_resident_bytes() : 0;
+    // Heap-held so the teardown below can time freeing the map itself
+    std::unique_ptr<Map> map_holder(new Map(Wrapper::create(initial_capacity(keys.size()))));
+    Map& map = *map_holder;
     
     // Insert benchmark
     LOG_DEBUG("Starting insert benchmark...");
+    perf_start();
     Timer timer;
-    if constexpr (has_batch_insert<Wrapper>::value) {
-        std::vector<uint64_t> values(keys.size(), 0);
-        Wrapper::batch_insert(map, keys, values);
-    } else {
-        for (const auto& key : keys) {
-            Wrapper::insert(map, key, uint64_t{0});
-        }
-    }
+    insert_phase<Wrapper>(map, keys, sampling ? &insert_hist : nullptr, result);
     result.insert_time_sec = timer.elapsed();
+    result.insert_perf = perf_stop(keys.size());
+    result.raw_bytes = raw_kv_bytes(keys);
+    if (hugepage_mode() != HugePageMode::Off) {
+        result.hugepages = hugepage_mode_name(hugepage_mode());
+        result.huge_page_bytes = std::max(hugepage_resident_bytes(), base_huge_bytes) - base_huge_bytes;
+    }
     
     LOG_INFO("Insert completed in %.6f seconds (%.2f Mops/sec)", 
              result.insert_time_sec, 
@@ -89,19 +424,60 @@ BenchmarkResult benchmark_string_keys(
     
     // Query benchmark
     LOG_DEBUG("Starting query benchmark...");
+    perf_start();
     timer.reset();
-    for (const auto& key : keys) {
-        side_effect += Wrapper::lookup(map, key);
-    }
+    side_effect += query_keys<Wrapper>(map, keys, sampling ? &query_hist : nullptr);
     result.query_time_sec = timer.elapsed();
+    result.query_perf = perf_stop(query_order.empty() ? keys.size() : query_order.size());
+    result.key_store = queries_key_store(keys);
+    
+    // Miss benchmark
+    // A --load-factor-sweep point may insert only a prefix of the keys
+    if (string_miss_keys.size() >= keys.size()) {
+        perf_start();
+        timer.reset();
+        side_effect += lookup_misses<Wrapper>(map, string_miss_keys, keys.size());
+        result.miss_time_sec = timer.elapsed();
+        result.miss_perf = perf_stop(keys.size());
+    }
+    
+    if (query_node >= 0) {
+        benchmark_remote_query<Wrapper>(map, keys, result);
+    }
+    
+    if (batch_size > 0) {
+        benchmark_batched<Wrapper>(map, keys, batch_values, result);
+    }
+    
+    if (view_lookup) {
+        benchmark_view_query<Wrapper>(map, keys, result);
+    }
+    
+    // Clear-and-reuse: empty the map in place, then fill it again
+    LOG_DEBUG("Clearing map...");
+    timer.reset();
+    clear_map<Wrapper>(map, keys);
+    result.clear_time_sec = has_clear<Wrapper>::value ? timer.elapsed()
+                                                      : std::numeric_limits<double>::quiet_NaN();
+    timer.reset();
+    insert_keys<Wrapper>(map, keys, nullptr);
+    result.reuse_insert_time_sec = timer.elapsed();
+    
+    if (sampling) {
+        result.insert_latency = insert_hist.summary(Clock::ns_per_tick());
+        result.query_latency = query_hist.summary(Clock::ns_per_tick());
+    }
     
     LOG_INFO("Query completed in %.6f seconds (%.2f Mops/sec)", 
              result.query_time_sec, 
              keys.size() / result.query_time_sec / 1000000.0);
     
-    // Cleanup
+    trace_growth<Wrapper>(keys, result);
+    
+    // Teardown: arena-backed maps release whole slabs instead of every node
     LOG_DEBUG("Destroying map...");
-    Wrapper::destroy(map);
+    result.destroy_time_sec = destroy_map<Wrapper>(map_holder);
+    measure_memory<Wrapper>(keys, keys.size(), result);
     
     return result;
 }
@@ -113,36 +489,54 @@ BenchmarkResult benchmark_string_keys(
 template <typename Wrapper>
 BenchmarkResult benchmark_int_keys(
     const std::string& impl_name,
+    const std::string& key_type,
     const std::vector<uint64_t>& keys,
     const std::string& comments = "") {
     
     using Map = typename Wrapper::Map;
     
+    if (!current_workload.ops.empty()) {
+        return WorkloadBenchmark<Wrapper>::run(
+            impl_name, key_type, keys, current_workload, latency_sample_every, comments);
+    }
+    
     LOG_INFO("Benchmarking %s with int keys (%zu elements)...", 
              impl_name.c_str(), keys.size());
     
     BenchmarkResult result;
     result.impl_name = impl_name;
-    result.key_type = "int64";
+    result.key_type = key_type;
     result.num_elements = keys.size();
     result.comments = comments;
+    if (!query_order.empty()) {
+        result.access_pattern = describe_access_distribution(access_distribution);
+    }
+    
+    // Allocated up front, outside the timed phases
+    LatencyHistogram insert_hist;
+    LatencyHistogram query_hist;
+    bool sampling = latency_sample_every > 0;
+    std::vector<uint64_t> batch_values(batch_size, 0);
     
     // Create map
     LOG_DEBUG("Creating map...");
-    Map map = Wrapper::create(keys.size());
+    size_t base_huge_bytes = hugepage_mode() != HugePageMode::Off ? hugepage_resident_bytes() : 0;
+    // Heap-held so the teardown below can time freeing the map itself
+    std::unique_ptr<Map> map_holder(new Map(Wrapper::create(initial_capacity(keys.size()))));
+    Map& map = *map_holder;
     
     // Insert benchmark
     LOG_DEBUG("Starting insert benchmark...");
+    perf_start();
     Timer timer;
-    if constexpr (has_batch_insert<Wrapper>::value) {
-        std::vector<uint64_t> values(keys.size(), 0);
-        Wrapper::batch_insert(map, keys, values);
-    } else {
-        for (const auto& key : keys) {
-            Wrapper::insert(map, key, uint64_t{0});
-        }
-    }
+    insert_phase<Wrapper>(map, keys, sampling ? &insert_hist : nullptr, result);
     result.insert_time_sec = timer.elapsed();
+    result.insert_perf = perf_stop(keys.size());
+    result.raw_bytes = raw_kv_bytes(keys);
+    if (hugepage_mode() != HugePageMode::Off) {
+        result.hugepages = hugepage_mode_name(hugepage_mode());
+        result.huge_page_bytes = std::max(hugepage_resident_bytes(), base_huge_bytes) - base_huge_bytes;
+    }
     
     LOG_INFO("Insert completed in %.6f seconds (%.2f Mops/sec)", 
              result.insert_time_sec, 
@@ -150,23 +544,225 @@ BenchmarkResult benchmark_int_keys(
     
     // Query benchmark
     LOG_DEBUG("Starting query benchmark...");
+    perf_start();
     timer.reset();
-    for (const auto& key : keys) {
-        side_effect += Wrapper::lookup(map, key);
-    }
+    side_effect += lookup_keys<Wrapper>(map, keys, sampling ? &query_hist : nullptr);
     result.query_time_sec = timer.elapsed();
+    result.query_perf = perf_stop(query_order.empty() ? keys.size() : query_order.size());
+    
+    // Miss benchmark
+    // A --load-factor-sweep point may insert only a prefix of the keys
+    if (int_miss_keys.size() >= keys.size()) {
+        perf_start();
+        timer.reset();
+        side_effect += lookup_misses<Wrapper>(map, int_miss_keys, keys.size());
+        result.miss_time_sec = timer.elapsed();
+        result.miss_perf = perf_stop(keys.size());
+    }
+    
+    if (query_node >= 0) {
+        benchmark_remote_query<Wrapper>(map, keys, result);
+    }
+    
+    if (batch_size > 0) {
+        benchmark_batched<Wrapper>(map, keys, batch_values, result);
+    }
+    
+    // Clear-and-reuse: empty the map in place, then fill it again
+    LOG_DEBUG("Clearing map...");
+    timer.reset();
+    clear_map<Wrapper>(map, keys);
+    result.clear_time_sec = has_clear<Wrapper>::value ? timer.elapsed()
+                                                      : std::numeric_limits<double>::quiet_NaN();
+    timer.reset();
+    insert_keys<Wrapper>(map, keys, nullptr);
+    result.reuse_insert_time_sec = timer.elapsed();
+    
+    if (sampling) {
+        result.insert_latency = insert_hist.summary(Clock::ns_per_tick());
+        result.query_latency = query_hist.summary(Clock::ns_per_tick());
+    }
     
     LOG_INFO("Query completed in %.6f seconds (%.2f Mops/sec)", 
              result.query_time_sec, 
              keys.size() / result.query_time_sec / 1000000.0);
     
-    // Cleanup
+    trace_growth<Wrapper>(keys, result);
+    
+    // Teardown: arena-backed maps release whole slabs instead of every node
+    LOG_DEBUG("Destroying map...");
+    result.destroy_time_sec = destroy_map<Wrapper>(map_holder);
+    measure_memory<Wrapper>(keys, keys.size(), result);
+    
+    return result;
+}
+
+// ============================================================================
+// Concurrent benchmarks (shared map, keys partitioned across pinned threads)
+// ============================================================================
+
+template <typename Wrapper, typename Key>
+BenchmarkResult benchmark_concurrent(
+    const std::string& impl_name,
+    const std::string& key_type,
+    const std::vector<Key>& keys,
+    int threads,
+    const std::string& comments = "") {
+    
+    using Map = typename Wrapper::Map;
+    
+    LOG_INFO("Benchmarking %s with %s keys (%zu elements, %d threads)...", 
+             impl_name.c_str(), key_type.c_str(), keys.size(), threads);
+    
+    BenchmarkResult result;
+    result.impl_name = impl_name;
+    result.key_type = key_type;
+    result.num_elements = keys.size();
+    result.comments = comments;
+    result.num_threads = threads;
+    result.thread_insert_sec.assign(threads, 0.0);
+    result.thread_query_sec.assign(threads, 0.0);
+    
+    // Main thread joins every phase boundary so it can time the aggregate
+    std::vector<int> cpus = available_cpus();
+    std::vector<uint64_t> sums(threads, 0);
+    std::barrier sync(threads + 1);
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    
+    Map map = Wrapper::create(initial_capacity(keys.size()));
+    
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t] {
+            if (!cpus.empty()) {
+                pin_current_thread(cpus[t % cpus.size()]);
+            }
+            // Id 0 belongs to the thread that created the map
+            if constexpr (has_thread_init<Wrapper>::value) {
+                Wrapper::thread_init(map, t + 1);
+            }
+            size_t begin = keys.size() * t / threads;
+            size_t end = keys.size() * (t + 1) / threads;
+            
+            sync.arrive_and_wait();
+            Timer timer;
+            for (size_t i = begin; i < end; i++) {
+                Wrapper::insert(map, keys[i], uint64_t{0});
+            }
+            result.thread_insert_sec[t] = timer.elapsed();
+            sync.arrive_and_wait();
+            
+            sync.arrive_and_wait();
+            uint64_t sum = 0;
+            timer.reset();
+            for (size_t i = begin; i < end; i++) {
+                sum += Wrapper::lookup(map, keys[i]);
+            }
+            result.thread_query_sec[t] = timer.elapsed();
+            sums[t] = sum;
+            sync.arrive_and_wait();
+        });
+    }
+    
+    // Insert phase
+    sync.arrive_and_wait();
+    Timer timer;
+    sync.arrive_and_wait();
+    result.insert_time_sec = timer.elapsed();
+    result.raw_bytes = raw_kv_bytes(keys);
+    
+    // Query phase
+    sync.arrive_and_wait();
+    timer.reset();
+    sync.arrive_and_wait();
+    result.query_time_sec = timer.elapsed();
+    
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (uint64_t sum : sums) {
+        side_effect += sum;
+    }
+    
     LOG_DEBUG("Destroying map...");
     Wrapper::destroy(map);
+    // Memory pass is single-threaded, so per-thread allocator caches are
+    // not part of the figure
+    measure_memory<Wrapper>(keys, keys.size(), result);
     
     return result;
 }
 
+// Run every selected registry entry that supports the key type (IntKeys picks
+// the IntWrapper, else the StringWrapper) through bench, printing one table
+// under title. Sections with no selected entry print nothing.
+template <bool IntKeys, typename Registry, typename Pred, typename Bench>
+std::vector<BenchmarkResult> run_section(
+    const Registry& registry, const std::string& title, bool run_all_impls, Pred include, Bench bench) {
+    
+    std::vector<BenchmarkResult> results;
+    for_each_impl(registry, [&](const auto& entry) {
+        using Entry = std::decay_t<decltype(entry)>;
+        using Wrapper = std::conditional_t<IntKeys,
+            typename Entry::IntWrapper, typename Entry::StringWrapper>;
+        if constexpr (!std::is_void_v<Wrapper>) {
+            if (include(entry) && impl_selected(entry, impl_filter, run_all_impls)) {
+                if (results.empty()) {
+                    std::cout << "\n=== " << title << " ===\n";
+                }
+                results.push_back(bench(entry, static_cast<Wrapper*>(nullptr)));
+            }
+        }
+    });
+    if (!results.empty()) {
+        print_results(results);
+    }
+    return results;
+}
+
+// Runs bench on the keys Wrapper takes at this --load-factor-sweep point: a
+// prefix of keys when sweep_key_count() trims them, else keys itself
+template <typename Wrapper, typename Key, typename Bench>
+BenchmarkResult with_sweep_keys(const std::vector<Key>& keys, Bench bench) {
+    size_t count = sweep_key_count<Wrapper>(keys.size());
+    if (count == keys.size()) {
+        return bench(keys);
+    }
+    return bench(std::vector<Key>(keys.begin(), keys.begin() + count));
+}
+
+std::vector<BenchmarkResult> run_concurrent_string_benchmarks(
+    const std::string& key_type, const std::vector<std::string>& keys) {
+    
+    std::string title = "Concurrent Containers - String Key (" + key_type + ", "
+                      + std::to_string(num_threads) + " threads)";
+    return run_section<false>(kConcurrentImplementations, title, true,
+        [](const auto&) { return true; },
+        [&](const auto& entry, auto* wrapper) {
+            using Wrapper = std::remove_pointer_t<decltype(wrapper)>;
+            return with_sweep_keys<Wrapper>(keys, [&](const auto& point_keys) {
+                return benchmark_concurrent<Wrapper>(
+                    entry.display_name, key_type, point_keys, num_threads, impl_comment(entry, "string"));
+            });
+        });
+}
+
+std::vector<BenchmarkResult> run_concurrent_int_benchmarks(
+    const std::string& key_type, const std::vector<uint64_t>& keys) {
+    
+    std::string title = "Concurrent Containers - Integer Key ("
+                      + (key_type == "int64" ? "" : key_type + ", ") + std::to_string(num_threads) + " threads)";
+    return run_section<true>(kConcurrentImplementations, title, true,
+        [](const auto&) { return true; },
+        [&](const auto& entry, auto* wrapper) {
+            using Wrapper = std::remove_pointer_t<decltype(wrapper)>;
+            return with_sweep_keys<Wrapper>(keys, [&](const auto& point_keys) {
+                return benchmark_concurrent<Wrapper>(
+                    entry.display_name, key_type, point_keys, num_threads, impl_comment(entry, "int64"));
+            });
+        });
+}
+
 // ============================================================================
 // All benchmarks runner
 // ============================================================================
@@ -184,6 +780,12 @@ std::vector<BenchmarkResult> run_all_string_benchmarks(
         generate_mid_keys(keys, num_power);
     } else if (key_type == "long_string") {
         generate_long_keys(keys, num_power);
+    } else if (KeySpec spec = key_shape; parse_key_spec(key_type, spec)) {
+        generate_string_keys(keys, num_power, spec, seed);
+    } else if (key_type == kFileKeyType && corpus_keys > 0) {
+        key_corpus.copy_keys(keys, corpus_keys);
+    } else if (key_type == kTraceKeyType && trace_loaded) {
+        keys = replay_trace.keys;
     } else {
         LOG_INFO( "Unknown key type: %s", key_type.c_str());
         return results;
@@ -191,81 +793,60 @@ std::vector<BenchmarkResult> run_all_string_benchmarks(
     
     LOG_DEBUG( "Generated %zu keys of type %s", keys.size(), key_type.c_str());
     
-    // Unordered (hash) containers
-    std::cout << "\n=== Unordered Containers - String Key (" << key_type << ") ===\n";
-    
-    // std::unordered_map
-    results.push_back(benchmark_string_keys<StdUnorderedMapWrapper<std::string, uint64_t>>(
-        "std::unordered_map", key_type, keys, "KV: string/uintptr_t"));
-    
-    // absl::flat_hash_map
-    results.push_back(benchmark_string_keys<AbslFlatHashMapWrapper<std::string, uint64_t>>(
-        "absl::flat_hash_map", key_type, keys, "KV: string/uintptr_t"));
-    
-    // absl::node_hash_map
-    results.push_back(benchmark_string_keys<AbslNodeHashMapWrapper<std::string, uint64_t>>(
-        "absl::node_hash_map", key_type, keys, "KV: string/uintptr_t"));
-
-    // folly::F14FastMap
-    results.push_back(benchmark_string_keys<FollyF14FastMapWrapper<std::string, uint64_t>>(
-        "folly::F14FastMap", key_type, keys, "KV: string/uintptr_t"));
-    
-    // google::dense_hash_map
-    results.push_back(benchmark_string_keys<DenseHashMapWrapper<std::string, uint64_t>>(
-        "google::dense_hash_map", key_type, keys, "KV: string/uintptr_t"));
-    
-    // google::sparse_hash_map
-    results.push_back(benchmark_string_keys<SparseHashMapWrapper<std::string, uint64_t>>(
-        "google::sparse_hash_map", key_type, keys, "KV: string/uintptr_t"));
-
-    if (run_all_impls) {
-        // cista::hash_map
-        results.push_back(benchmark_string_keys<CistaHashMapWrapper<std::string, uint64_t>>(
-            "cista::hash_map", key_type, keys, "KV: string/uintptr_t"));
-        
-        // libcuckoo::cuckoohash_map
-        results.push_back(benchmark_string_keys<CuckooHashMapWrapper<std::string, uint64_t>>(
-            "libcuckoo::cuckoohash_map", key_type, keys, "KV: string/uintptr_t"));
-        
-        // rhashmap (C library)
-        results.push_back(benchmark_string_keys<RhashmapWrapper>(
-            "rhashmap", key_type, keys, "KV: string/uintptr_t"));
-        
-        // phmap::flat_hash_map
-        results.push_back(benchmark_string_keys<PhmapFlatHashMapWrapper<std::string, uint64_t>>(
-            "phmap::flat_hash_map", key_type, keys, "KV: string/uintptr_t"));
-        
-        // phmap::parallel_flat_hash_map
-        results.push_back(benchmark_string_keys<PhmapParallelHashMapWrapper<std::string, uint64_t>>(
-            "phmap::parallel_flat_hash_map", key_type, keys, "KV: string/uintptr_t"));
+    if (!scattered_keys || view_lookup) {
+        // A corpus is packed straight from its mapping, not from the copies
+        if (key_type == kFileKeyType && corpus_keys > 0) {
+            string_key_store.assign(key_corpus.keys(), keys.size());
+        } else {
+            string_key_store.assign(keys);
+        }
+        LOG_DEBUG("Packed %zu keys into a %zu-byte key store", keys.size(), string_key_store.bytes());
+    } else {
+        string_key_store.clear();
+    }
+    if (!scattered_keys) {
+        // Inserts and non-transparent lookups take const std::string&; build
+        // those strings once, in key order, from the store
+        std::vector<std::string> stored;
+        stored.reserve(string_key_store.size());
+        for (size_t i = 0; i < string_key_store.size(); i++) {
+            stored.emplace_back(string_key_store[i]);
+        }
+        keys.swap(stored);
     }
-
-    // Print unordered results
-    print_results(results);
-
-    // Ordered containers
-    std::cout << "\n=== Ordered Containers - String Key (" << key_type << ") ===\n";
-    
-    size_t ordered_start = results.size();
-    
-    // std::map
-    results.push_back(benchmark_string_keys<StdMapWrapper<std::string, uint64_t>>(
-        "std::map", key_type, keys, "KV: string/uintptr_t, Ordered"));
     
-    // absl::btree_map
-    results.push_back(benchmark_string_keys<AbslBtreeMapWrapper<std::string, uint64_t>>(
-        "absl::btree_map", key_type, keys, "KV: string/uintptr_t, Ordered"));
+    // Only the thread-safe containers take part in the concurrent mode
+    if (num_threads > 1) {
+        return run_concurrent_string_benchmarks(key_type, keys);
+    }
     
-    // boost::container::flat_map
-    results.push_back(benchmark_string_keys<BoostFlatMapWrapper<std::string, uint64_t>>(
-        "boost::flat_map", key_type, keys, "KV: string/uintptr_t, Ordered"));
+    generate_miss_keys(keys, string_miss_keys);
     
-    // folly::sorted_vector_map
-    results.push_back(benchmark_string_keys<FollySortedVectorMapWrapper<std::string, uint64_t>>(
-        "folly::sorted_vector_map", key_type, keys, "KV: string/uintptr_t, Ordered"));
+    if (workload_enabled) {
+        current_workload = generate_workload(workload_mix, keys.size(), keys.size(), seed);
+        std::cout << "\n" << describe_workload(current_workload) << "\n";
+    } else if (trace_loaded) {
+        current_workload = replay_trace.workload;
+        std::cout << "\n" << describe_workload(current_workload) << "\n";
+    } else if (access_distribution.pattern != AccessPattern::Sequential) {
+        generate_access_indices(query_order, keys.size(), keys.size(), access_distribution, seed);
+        std::cout << "\nQuery access: " << describe_access_distribution(access_distribution) << "\n";
+    }
     
-    // Print ordered results only
-    print_results(std::vector<BenchmarkResult>(results.begin() + ordered_start, results.end()));
+    auto bench = [&](const auto& entry, auto* wrapper) {
+        using Wrapper = std::remove_pointer_t<decltype(wrapper)>;
+        return with_sweep_keys<Wrapper>(keys, [&](const auto& point_keys) {
+            return benchmark_string_keys<Wrapper>(
+                entry.display_name, key_type, point_keys, impl_comment(entry, "string"));
+        });
+    };
+    for (bool ordered : {false, true}) {
+        std::string title = std::string(ordered ? "Ordered" : "Unordered") + " Containers - String Key ("
+                          + key_type + ")";
+        auto section = run_section<false>(kImplementations, title, run_all_impls,
+            [ordered](const auto& entry) { return entry.ordered == ordered; }, bench);
+        results.insert(results.end(), section.begin(), section.end());
+    }
     
     return results;
 }
@@ -273,91 +854,53 @@ std::vector<BenchmarkResult> run_all_string_benchmarks(
 std::vector<BenchmarkResult> run_all_int_benchmarks(int num_power, bool run_all_impls) {
     std::vector<BenchmarkResult> results;
     
-    // Generate keys
+    // Generate keys; recorded ones are labelled apart from the generated int64
+    // set so results and baselines never pair the two
     std::vector<uint64_t> keys;
-    generate_int_keys(keys, num_power);
+    std::string key_type = "int64";
+    if (trace_loaded && replay_trace.int_keyed) {
+        keys = replay_trace.int_keys;
+        key_type = kIntTraceKeyType;
+    } else if (corpus_keys > 0 && key_corpus.is_int()) {
+        key_corpus.copy_keys(keys, corpus_keys);
+        key_type = kIntFileKeyType;
+    } else {
+        generate_int_keys(keys, num_power);
+    }
     
     LOG_DEBUG( "Generated %zu int keys", keys.size());
     
-    // Unordered (hash) containers
-    std::cout << "\n=== Unordered Containers - Integer Key ===\n";
-    
-    // std::unordered_map
-    results.push_back(benchmark_int_keys<StdUnorderedMapWrapper<uint64_t, uint64_t>>(
-        "std::unordered_map", keys, "KV: int64/uintptr_t"));
-    
-    // absl::flat_hash_map
-    results.push_back(benchmark_int_keys<AbslFlatHashMapWrapper<uint64_t, uint64_t>>(
-        "absl::flat_hash_map", keys, "KV: int64/uintptr_t"));
-    
-    // absl::node_hash_map
-    results.push_back(benchmark_int_keys<AbslNodeHashMapWrapper<uint64_t, uint64_t>>(
-        "absl::node_hash_map", keys, "KV: int64/uintptr_t"));
-
-    // folly::F14FastMap
-    results.push_back(benchmark_int_keys<FollyF14FastMapWrapper<uint64_t, uint64_t>>(
-        "folly::F14FastMap", keys, "KV: int64/uintptr_t"));
-    
-    // google::dense_hash_map
-    results.push_back(benchmark_int_keys<DenseHashMapWrapper<uint64_t, uint64_t>>(
-        "google::dense_hash_map", keys, "KV: int64/uintptr_t"));
-    
-    // google::sparse_hash_map
-    results.push_back(benchmark_int_keys<SparseHashMapWrapper<uint64_t, uint64_t>>(
-        "google::sparse_hash_map", keys, "KV: int64/uintptr_t"));
-    
-    // CLHT (Lock-Based and Lock-Free hash tables)
-    results.push_back(benchmark_int_keys<ClhtLbWrapper>("CLHT-LB", keys, "✅ Lock-Based, KV: int64/uintptr_t"));
-    results.push_back(benchmark_int_keys<ClhtLfWrapper>("CLHT-LF", keys, "✅ Lock-Free, KV: int64/uintptr_t"));
-
-    if (run_all_impls) {
-        // cista::hash_map
-        results.push_back(benchmark_int_keys<CistaHashMapWrapper<uint64_t, uint64_t>>(
-            "cista::hash_map", keys, "KV: int64/uintptr_t"));
-        
-        // libcuckoo::cuckoohash_map
-        results.push_back(benchmark_int_keys<CuckooHashMapWrapper<uint64_t, uint64_t>>(
-            "libcuckoo::cuckoohash_map", keys, "KV: int64/uintptr_t"));
-        
-        // OPIC Robin Hood Hash
-        results.push_back(benchmark_int_keys<OpicRobinHoodWrapper>(
-            "OPIC::robin_hood", keys, "KV: int64/uintptr_t"));
-        
-        // phmap::flat_hash_map
-        results.push_back(benchmark_int_keys<PhmapFlatHashMapWrapper<uint64_t, uint64_t>>(
-            "phmap::flat_hash_map", keys, "KV: int64/uintptr_t"));
-        
-        // phmap::parallel_flat_hash_map
-        results.push_back(benchmark_int_keys<PhmapParallelHashMapWrapper<uint64_t, uint64_t>>(
-            "phmap::parallel_flat_hash_map", keys, "KV: int64/uintptr_t"));
+    if (num_threads > 1) {
+        return run_concurrent_int_benchmarks(key_type, keys);
     }
-
-    // Print unordered results
-    print_results(results);
-
-    // Ordered containers
-    std::cout << "\n=== Ordered Containers - Integer Key ===\n";
-    
-    size_t ordered_start = results.size();
-    
-    // std::map
-    results.push_back(benchmark_int_keys<StdMapWrapper<uint64_t, uint64_t>>(
-        "std::map", keys, "KV: int64/uintptr_t, Ordered"));
     
-    // absl::btree_map
-    results.push_back(benchmark_int_keys<AbslBtreeMapWrapper<uint64_t, uint64_t>>(
-        "absl::btree_map", keys, "KV: int64/uintptr_t, Ordered"));
+    generate_miss_keys(keys, int_miss_keys);
     
-    // boost::container::flat_map
-    results.push_back(benchmark_int_keys<BoostFlatMapWrapper<uint64_t, uint64_t>>(
-        "boost::flat_map", keys, "KV: int64/uintptr_t, Ordered"));
-    
-    // folly::sorted_vector_map
-    results.push_back(benchmark_int_keys<FollySortedVectorMapWrapper<uint64_t, uint64_t>>(
-        "folly::sorted_vector_map", keys, "KV: int64/uintptr_t, Ordered"));
+    if (workload_enabled) {
+        current_workload = generate_workload(workload_mix, keys.size(), keys.size(), seed);
+        std::cout << "\n" << describe_workload(current_workload) << "\n";
+    } else if (trace_loaded) {
+        current_workload = replay_trace.workload;
+        std::cout << "\n" << describe_workload(current_workload) << "\n";
+    } else if (access_distribution.pattern != AccessPattern::Sequential) {
+        generate_access_indices(query_order, keys.size(), keys.size(), access_distribution, seed);
+        std::cout << "\nQuery access: " << describe_access_distribution(access_distribution) << "\n";
+    }
     
-    // Print ordered results only
-    print_results(std::vector<BenchmarkResult>(results.begin() + ordered_start, results.end()));
+    auto bench = [&](const auto& entry, auto* wrapper) {
+        using Wrapper = std::remove_pointer_t<decltype(wrapper)>;
+        return with_sweep_keys<Wrapper>(keys, [&](const auto& point_keys) {
+            return benchmark_int_keys<Wrapper>(
+                entry.display_name, key_type, point_keys, impl_comment(entry, "int64"));
+        });
+    };
+    for (bool ordered : {false, true}) {
+        std::string title = std::string(ordered ? "Ordered" : "Unordered") + " Containers - Integer Key"
+                          + (key_type == "int64" ? "" : " (" + key_type + ")");
+        auto section = run_section<true>(kImplementations, title, run_all_impls,
+            [ordered](const auto& entry) { return entry.ordered == ordered; }, bench);
+        results.insert(results.end(), section.begin(), section.end());
+    }
     
     return results;
 }
@@ -366,24 +909,114 @@ std::vector<BenchmarkResult> run_all_int_benchmarks(int num_power, bool run_all_
 // Main function
 // ============================================================================
 
+// Discards everything written to std::cout while alive (warmup repetitions)
+class SilenceStdout {
+public:
+    SilenceStdout() : saved_(std::cout.rdbuf(&null_)) {}
+    ~SilenceStdout() { std::cout.rdbuf(saved_); }
+
+private:
+    struct NullBuffer : std::streambuf {
+        int overflow(int c) override { return traits_type::not_eof(c); }
+    };
+    NullBuffer null_;
+    std::streambuf* saved_;
+};
+
 void print_help(const char* program) {
     std::cout << 
         "Usage: " << program << " [OPTIONS]\n"
         "\n"
         "Options:\n"
         "  -n POWER      Number of elements as power of 2 (default: 20, i.e., 2^20 = 1M)\n"
-        "  -k KEYTYPE    Key type: short_string, mid_string, long_string, int (default: short_string)\n"
+        "  -k KEYTYPE    Key type: short_string, mid_string, long_string, int (default: short_string),\n"
+        "                or str:LEN / str:MIN-MAX for unique keys of that length (uniform range)\n"
         "  -a            Run all key types and all implementations\n"
-        "  -i IMPL       Run only specified implementation\n"
-        "  -r REPEAT     Number of repetitions (default: 1)\n"
+        "  -i IMPL       Run only the named implementations: comma list of names or globs\n"
+        "                (e.g. -i absl_flat_hash_map,'phmap_*'); named ones run even without -a\n"
+        "  -r REPEAT     Number of repetitions (default: 1); with more than one, a summary\n"
+        "                reports min/median/mean/stddev/95% CI of Mops/s per implementation\n"
         "  -p PAUSE      Pause seconds between insert and query (default: 0)\n"
-        "  -c FACTOR     CLHT capacity factor (default: 4)\n"
+        "  -c FACTOR     CLHT slots per key: N*FACTOR/3 buckets of 3 slots (default: 3)\n"
+        "  -t THREADS    Concurrent mode: N pinned threads share one map (thread-safe maps only)\n"
+        "  -l SAMPLE     Time every SAMPLE-th insert/lookup and report p50/p99/p99.9/max latency\n"
+        "  -w WORKLOAD   Replay a mixed workload instead of insert-all/lookup-all:\n"
+        "                ycsb-a|ycsb-b|ycsb-c|ycsb-d|ycsb-f or ratios insert:update:hit:miss:erase[:rmw]\n"
+        "  -d DIST       Query-phase key access: seq (default), uniform, zipf[:THETA],\n"
+        "                hotset[:OPS:KEYS] (e.g. hotset:90:10), latest[:THETA]; not with -w\n"
+        "                or --trace, which pick the key of every operation\n"
+        "  -s SEED       Seed for generated operation streams (default: 1)\n"
+        "  --clock SRC   Timing backend: tsc (invariant TSC, default) or steady\n"
+        "  --warmup N    Run N unreported repetitions first (default: 0)\n"
+        "  --format FMT  Result format: table (default), csv or jsonl; every record carries\n"
+        "                host, compiler, build flags, git SHA, N and seed\n"
+        "  --output FILE Write csv/jsonl records to FILE (format from the extension unless\n"
+        "                --format is given); without it records replace the tables on stdout\n"
+        "  --compare FILE\n"
+        "                Compare insert/query Mops/s and memory per (impl, key type, N) with a\n"
+        "                --format=jsonl baseline; exit 2 on a significant (Welch t-test)\n"
+        "                regression beyond the threshold\n"
+        "  --threshold PCT\n"
+        "                Regression threshold for --compare (default: 5)\n"
+        "  --perf        Report cycles, instructions, L1D/LLC/dTLB misses and branch misses\n"
+        "                per operation of each phase (single-threaded runs, perf_event_open)\n"
+        "  --batch B     Also look up and insert every key in groups of B through the\n"
+        "                wrappers' batch API (hash + prefetch pipelining where the map\n"
+        "                supports it) and report the speedup over the scalar loops\n"
+        "  --numa-node N Run the benchmark (and -t worker) threads on NUMA node N's CPUs\n"
+        "  --mem-node NODES\n"
+        "                Bind every allocation to NODES (e.g. 0 or 0,1) with set_mempolicy\n"
+        "  --interleave[=NODES]\n"
+        "                Interleave allocations page by page over NODES (default: all)\n"
+        "  --query-node N\n"
+        "                After the query phase, repeat it from node N's CPUs and report the\n"
+        "                remote-access slowdown (e.g. --numa-node 0 --query-node 1)\n"
+        "  --hugepages MODE\n"
+        "                Back container arrays of 2 MB and up with huge pages: off (default),\n"
+        "                thp (madvise MADV_HUGEPAGE) or hugetlb (MAP_HUGETLB, else thp);\n"
+        "                combine with --perf and --compare to see the dTLB-miss and Mops/s delta\n"
+        "  --no-reserve  Create every map empty instead of pre-sized for N keys, and trace each\n"
+        "                resize (size, old and new capacity, time of the growing insert) where\n"
+        "                the map reports its capacity; traced inserts read the clock every time\n"
+        "  --load-factor-sweep MIN:MAX:STEP\n"
+        "                Run the suite once per target occupancy (e.g. 0.5:0.95:0.05): maps that\n"
+        "                report their capacity are sized for about N/2 keys and get target x\n"
+        "                capacity keys (at most N); ends with the achieved occupancy, Mops/s and\n"
+        "                bytes/entry per point; not with -d, -w or --trace\n"
+        "  --key-alphabet SET\n"
+        "                Characters of str:LEN keys: alnum (default), hex, digits, printable or\n"
+        "                the literal characters given\n"
+        "  --key-prefix N\n"
+        "                Start every str:LEN key with the same N characters (default: 0)\n"
+        "  --key-len-sweep MIN:MAX:STEP\n"
+        "                Run the string suite with str:LEN keys for each length (e.g. 8:80:8)\n"
+        "                and chart insert and query Mops/s against key length\n"
+        "  --keys-file PATH\n"
+        "                Benchmark the keys in PATH instead of generated ones (all of them, or\n"
+        "                the first 2^N with -n): one per line, HMBKEYS1 + uint32-length records,\n"
+        "                or HMBINTS1 + uint64 keys for the int suite; mapped, not parsed\n"
+        "  --trace PATH  Replay a recorded get/put/del trace (HMBTRACE format, see README) through\n"
+        "                each map, with throughput and latency per operation type; latency is\n"
+        "                sampled on every op unless -l says otherwise\n"
+        "  --scattered-keys\n"
+        "                Insert and query the generated std::string keys instead of the default\n"
+        "                contiguous key store (which maps with transparent lookup probe through\n"
+        "                std::string_view, the others through strings rebuilt from it once)\n"
+        "  --view-lookup Repeat the string query phase with std::string_view keys into one\n"
+        "                buffer; maps without transparent lookup copy each view to a string\n"
+        "  --target-ci PCT\n"
+        "                Repeat (at least 3, at most -r or 30 times) until every insert and\n"
+        "                query 95% CI is within PCT% of the mean\n"
         "  -h            Show this help\n"
         "\n"
         "Unordered (Hash) Implementations:\n"
         "  std_unordered_map      - std::unordered_map\n"
         "  absl_flat_hash_map     - absl::flat_hash_map\n"
         "  absl_node_hash_map     - absl::node_hash_map\n"
+        "  std_unordered_map_monotonic, absl_node_hash_map_monotonic\n"
+        "                         - node containers on a std::pmr::monotonic_buffer_resource\n"
+        "  std_unordered_map_slab, absl_node_hash_map_slab\n"
+        "                         - node containers on a size-class slab pool\n"
         "  folly_F14FastMap       - folly::F14FastMap\n"
         "  dense_hash_map         - google::dense_hash_map\n"
         "  sparse_hash_map        - google::sparse_hash_map\n"
@@ -398,6 +1031,8 @@ void print_help(const char* program) {
         "\n"
         "Ordered Implementations:\n"
         "  std_map                - std::map\n"
+        "  std_map_monotonic      - std::map on a std::pmr::monotonic_buffer_resource\n"
+        "  std_map_slab           - std::map on a size-class slab pool\n"
         "  absl_btree_map         - absl::btree_map\n"
         "  boost_flat_map         - boost::container::flat_map\n"
         "  folly_sorted_vector_map- folly::sorted_vector_map\n"
@@ -410,19 +1045,89 @@ int main(int argc, char* argv[]) {
     
     // Default parameters
     int num_power = 20;
+    bool num_power_set = false;
     std::string key_type = "short_string";
     int repeat = 1;
+    bool repeat_set = false;
+    int warmup = 0;
+    double target_ci = 0;  // relative 95% CI half-width, 0 = fixed repetitions
+    OutputFormat output_format = OutputFormat::Table;
+    bool format_set = false;
+    std::string output_path;
+    std::string baseline_path;
+    double regression_threshold = 0.05;
     unsigned int pause = 0;
     bool run_all = false;
     bool run_all_impls = false;
     bool run_default = false;  // -n mode: short_string + int
-    std::string specific_impl;
+    ClockSource clock_source = ClockSource::Tsc;
+    int numa_node = -1;
+    MemPolicy mem_policy = MemPolicy::Default;
+    std::vector<int> mem_nodes;
+    std::vector<std::string> key_len_types;  // str:LEN key types of --key-len-sweep
+    std::string keys_file;
+    std::string trace_file;
+    
+    // Long-only options
+    enum {
+        OPT_CLOCK = 256,
+        OPT_WARMUP,
+        OPT_TARGET_CI,
+        OPT_FORMAT,
+        OPT_OUTPUT,
+        OPT_COMPARE,
+        OPT_THRESHOLD,
+        OPT_PERF,
+        OPT_BATCH,
+        OPT_NUMA_NODE,
+        OPT_MEM_NODE,
+        OPT_INTERLEAVE,
+        OPT_QUERY_NODE,
+        OPT_HUGEPAGES,
+        OPT_NO_RESERVE,
+        OPT_LOAD_FACTOR_SWEEP,
+        OPT_KEY_ALPHABET,
+        OPT_KEY_PREFIX,
+        OPT_KEY_LEN_SWEEP,
+        OPT_VIEW_LOOKUP,
+        OPT_SCATTERED_KEYS,
+        OPT_KEYS_FILE,
+        OPT_TRACE,
+    };
+    static const struct option long_options[] = {
+        {"clock", required_argument, nullptr, OPT_CLOCK},
+        {"warmup", required_argument, nullptr, OPT_WARMUP},
+        {"target-ci", required_argument, nullptr, OPT_TARGET_CI},
+        {"format", required_argument, nullptr, OPT_FORMAT},
+        {"output", required_argument, nullptr, OPT_OUTPUT},
+        {"compare", required_argument, nullptr, OPT_COMPARE},
+        {"threshold", required_argument, nullptr, OPT_THRESHOLD},
+        {"perf", no_argument, nullptr, OPT_PERF},
+        {"batch", required_argument, nullptr, OPT_BATCH},
+        {"numa-node", required_argument, nullptr, OPT_NUMA_NODE},
+        {"mem-node", required_argument, nullptr, OPT_MEM_NODE},
+        {"interleave", optional_argument, nullptr, OPT_INTERLEAVE},
+        {"query-node", required_argument, nullptr, OPT_QUERY_NODE},
+        {"hugepages", required_argument, nullptr, OPT_HUGEPAGES},
+        {"no-reserve", no_argument, nullptr, OPT_NO_RESERVE},
+        {"load-factor-sweep", required_argument, nullptr, OPT_LOAD_FACTOR_SWEEP},
+        {"key-alphabet", required_argument, nullptr, OPT_KEY_ALPHABET},
+        {"key-prefix", required_argument, nullptr, OPT_KEY_PREFIX},
+        {"key-len-sweep", required_argument, nullptr, OPT_KEY_LEN_SWEEP},
+        {"view-lookup", no_argument, nullptr, OPT_VIEW_LOOKUP},
+        {"scattered-keys", no_argument, nullptr, OPT_SCATTERED_KEYS},
+        {"keys-file", required_argument, nullptr, OPT_KEYS_FILE},
+        {"trace", required_argument, nullptr, OPT_TRACE},
+        {"help", no_argument, nullptr, 'h'},
+        {nullptr, 0, nullptr, 0},
+    };
     
     int opt;
-    while ((opt = getopt(argc, argv, "n:k:r:p:i:c:ah")) != -1) {
+    while ((opt = getopt_long(argc, argv, "n:k:r:p:i:c:t:l:w:d:s:ah", long_options, nullptr)) != -1) {
         switch (opt) {
             case 'n':
                 num_power = atoi(optarg);
+                num_power_set = true;
                 run_default = true;
                 break;
             case 'k':
@@ -431,6 +1136,7 @@ int main(int argc, char* argv[]) {
                 break;
             case 'r':
                 repeat = atoi(optarg);
+                repeat_set = true;
                 break;
             case 'p':
                 pause = atoi(optarg);
@@ -442,13 +1148,177 @@ int main(int argc, char* argv[]) {
                 }
                 break;
             }
+            case 't': {
+                int threads = atoi(optarg);
+                if (threads > 0) {
+                    num_threads = threads;
+                }
+                break;
+            }
+            case 'l': {
+                long long every = atoll(optarg);
+                if (every > 0) {
+                    latency_sample_every = static_cast<uint64_t>(every);
+                }
+                break;
+            }
+            case 'w':
+                if (!parse_workload(optarg, workload_mix)) {
+                    std::cerr << "Invalid workload: " << optarg << "\n";
+                    return 1;
+                }
+                workload_enabled = true;
+                break;
+            case 'd':
+                if (!parse_access_distribution(optarg, access_distribution)) {
+                    std::cerr << "Invalid access distribution: " << optarg << "\n";
+                    return 1;
+                }
+                break;
+            case 's':
+                seed = strtoull(optarg, nullptr, 10);
+                break;
             case 'i':
-                specific_impl = optarg;
+                impl_filter = optarg;
                 break;
             case 'a':
                 run_all = true;
                 run_all_impls = true;
                 break;
+            case OPT_CLOCK:
+                if (strcmp(optarg, "tsc") == 0) {
+                    clock_source = ClockSource::Tsc;
+                } else if (strcmp(optarg, "steady") == 0) {
+                    clock_source = ClockSource::SteadyClock;
+                } else {
+                    std::cerr << "Unknown clock source: " << optarg << "\n";
+                    return 1;
+                }
+                break;
+            case OPT_WARMUP:
+                warmup = std::max(0, atoi(optarg));
+                break;
+            case OPT_TARGET_CI:
+                target_ci = atof(optarg) / 100.0;
+                if (target_ci <= 0) {
+                    std::cerr << "Invalid --target-ci: " << optarg << "\n";
+                    return 1;
+                }
+                break;
+            case OPT_FORMAT:
+                if (!parse_output_format(optarg, output_format)) {
+                    std::cerr << "Unknown output format: " << optarg << "\n";
+                    return 1;
+                }
+                format_set = true;
+                break;
+            case OPT_OUTPUT:
+                output_path = optarg;
+                break;
+            case OPT_COMPARE:
+                baseline_path = optarg;
+                break;
+            case OPT_THRESHOLD:
+                regression_threshold = atof(optarg) / 100.0;
+                if (regression_threshold < 0) {
+                    std::cerr << "Invalid --threshold: " << optarg << "\n";
+                    return 1;
+                }
+                break;
+            case OPT_PERF:
+                perf_counters = std::make_unique<PerfCounters>();
+                if (!perf_counters->available()) {
+                    if (perf_counters->warning().empty()) {
+                        std::cerr << "Warning: perf_event_open failed for every counter (check "
+                                     "/proc/sys/kernel/perf_event_paranoid); continuing without --perf\n";
+                    } else {
+                        std::cerr << "Warning: " << perf_counters->warning() << "; continuing without --perf\n";
+                    }
+                    perf_counters.reset();
+                } else if (!perf_counters->warning().empty()) {
+                    std::cerr << "Warning: --perf: " << perf_counters->warning() << "\n";
+                }
+                break;
+            case OPT_BATCH: {
+                int size = atoi(optarg);
+                if (size <= 0) {
+                    std::cerr << "Invalid --batch: " << optarg << "\n";
+                    return 1;
+                }
+                batch_size = static_cast<uint32_t>(size);
+                break;
+            }
+            case OPT_NUMA_NODE:
+            case OPT_QUERY_NODE: {
+                std::vector<int> nodes;
+                if (!parse_node_list(optarg, nodes) || nodes.size() != 1 || numa_node_cpus(nodes[0]).empty()) {
+                    std::cerr << "Invalid NUMA node (needs one online node with usable CPUs): " << optarg << "\n";
+                    return 1;
+                }
+                (opt == OPT_NUMA_NODE ? numa_node : query_node) = nodes[0];
+                break;
+            }
+            case OPT_MEM_NODE:
+            case OPT_INTERLEAVE:
+                if (!parse_node_list(optarg ? optarg : "all", mem_nodes)) {
+                    std::cerr << "Invalid NUMA node list: " << (optarg ? optarg : "all") << "\n";
+                    return 1;
+                }
+                mem_policy = opt == OPT_MEM_NODE ? MemPolicy::Bind : MemPolicy::Interleave;
+                break;
+            case OPT_HUGEPAGES: {
+                HugePageMode mode;
+                if (!parse_hugepage_mode(optarg, mode)) {
+                    std::cerr << "Unknown --hugepages mode: " << optarg << " (off, thp or hugetlb)\n";
+                    return 1;
+                }
+                set_hugepage_mode(mode);
+                break;
+            }
+            case OPT_NO_RESERVE:
+                reserve_capacity = false;
+                break;
+            case OPT_LOAD_FACTOR_SWEEP:
+                if (!parse_sweep(optarg, 0.0, 1.0, load_factors)) {
+                    std::cerr << "Invalid --load-factor-sweep: " << optarg
+                              << " (MIN:MAX:STEP with 0 < MIN <= MAX <= 1, e.g. 0.5:0.95:0.05)\n";
+                    return 1;
+                }
+                break;
+            case OPT_KEY_ALPHABET:
+                if (!parse_key_alphabet(optarg, key_shape.alphabet)) {
+                    std::cerr << "Invalid --key-alphabet: " << optarg
+                              << " (alnum, hex, digits, printable or at least two ASCII characters)\n";
+                    return 1;
+                }
+                break;
+            case OPT_KEY_PREFIX:
+                key_shape.prefix_len = static_cast<size_t>(std::max(0, atoi(optarg)));
+                break;
+            case OPT_KEY_LEN_SWEEP: {
+                std::vector<double> lengths;
+                if (!parse_sweep(optarg, 0.0, 65536.0, lengths)) {
+                    std::cerr << "Invalid --key-len-sweep: " << optarg << " (MIN:MAX:STEP, e.g. 8:80:8)\n";
+                    return 1;
+                }
+                key_len_types.clear();
+                for (double length : lengths) {
+                    key_len_types.push_back("str:" + std::to_string(static_cast<size_t>(length)));
+                }
+                break;
+            }
+            case OPT_VIEW_LOOKUP:
+                view_lookup = true;
+                break;
+            case OPT_SCATTERED_KEYS:
+                scattered_keys = true;
+                break;
+            case OPT_KEYS_FILE:
+                keys_file = optarg;
+                break;
+            case OPT_TRACE:
+                trace_file = optarg;
+                break;
             case 'h':
                 print_help(argv[0]);
                 return 0;
@@ -464,44 +1334,328 @@ int main(int argc, char* argv[]) {
         return 0;
     }
     
+    // Placement is set before any key or map is allocated; worker threads of
+    // the concurrent mode inherit both the CPU set and the memory policy
+    if (numa_node >= 0 && !numa_run_on_node(numa_node)) {
+        std::cerr << "Cannot run on NUMA node " << numa_node << "\n";
+        return 1;
+    }
+    if (mem_policy != MemPolicy::Default && !numa_set_mempolicy(mem_policy, mem_nodes)) {
+        std::cerr << "set_mempolicy failed for nodes " << format_node_list(mem_nodes) << "\n";
+        return 1;
+    }
+    home_cpus = available_cpus();
+    
+    // The batched phases walk keys in insertion order, so their speedup is
+    // only meaningful against a sequential scalar query phase
+    if (batch_size > 0 && access_distribution.pattern != AccessPattern::Sequential) {
+        std::cerr << "--batch needs the sequential query order (drop -d)\n";
+        return 1;
+    }
+    
+    // A sweep point inserts a different number of keys per container, while
+    // -d, -w and --trace index the full key set
+    if (!load_factors.empty() && (access_distribution.pattern != AccessPattern::Sequential || workload_enabled ||
+                                  !trace_file.empty())) {
+        std::cerr << "--load-factor-sweep trims the key set per container, which -d, -w and --trace "
+                     "index in full\n";
+        return 1;
+    }
+    
+    // -w and --trace choose the key of every operation themselves, so a
+    // query distribution would have nothing to shape
+    if (access_distribution.pattern != AccessPattern::Sequential && (workload_enabled || !trace_file.empty())) {
+        std::cerr << "-d shapes the query phase, which -w and --trace replace (drop -d)\n";
+        return 1;
+    }
+    
+    // A key file replaces the generated key set: all of its keys, or the
+    // first 2^N with -n
+    if (!keys_file.empty()) {
+        if (run_all || !key_len_types.empty()) {
+            std::cerr << "--keys-file supplies a single key set (drop -a / --key-len-sweep)\n";
+            return 1;
+        }
+        std::string error;
+        if (!key_corpus.open(keys_file, error)) {
+            std::cerr << "Cannot load --keys-file " << error << "\n";
+            return 1;
+        }
+        if (num_power_set && (1ULL << num_power) > key_corpus.size()) {
+            std::cerr << keys_file << " holds " << key_corpus.size() << " keys, fewer than 2^" << num_power << "\n";
+            return 1;
+        }
+        corpus_keys = num_power_set ? 1ULL << num_power : key_corpus.size();
+        // Every phase inserts each key once and expects the map to hold all of them
+        if (size_t duplicates = key_corpus.count_duplicates(corpus_keys); duplicates > 0) {
+            std::cerr << keys_file << ": " << duplicates << " of the first " << corpus_keys
+                      << " keys repeat an earlier one; deduplicate the file\n";
+            return 1;
+        }
+        if (!num_power_set) {
+            // Largest power of two not above the key count, for the run metadata
+            num_power = 0;
+            while ((2ULL << num_power) <= corpus_keys) {
+                num_power++;
+            }
+        }
+        key_type = key_corpus.is_int() ? "int" : kFileKeyType;
+        run_default = false;
+    }
+    
+    // A trace brings its own keys and operation stream; it is decoded here,
+    // outside every timed region
+    if (!trace_file.empty()) {
+        if (run_all || !key_len_types.empty() || !keys_file.empty() || workload_enabled || num_threads > 1) {
+            std::cerr << "--trace replays a single recorded stream (drop -a, -w, -t, --keys-file, --key-len-sweep)\n";
+            return 1;
+        }
+        std::string error;
+        if (!load_trace(trace_file, replay_trace, error)) {
+            std::cerr << "Cannot load --trace " << error << "\n";
+            return 1;
+        }
+        trace_loaded = true;
+        key_type = replay_trace.int_keyed ? "int" : kTraceKeyType;
+        run_default = false;
+        // The per-operation breakdown comes from the latency samples
+        if (latency_sample_every == 0) {
+            latency_sample_every = 1;
+        }
+    }
+    
+    // Every parametric key type must leave room for the unique suffix
+    std::vector<std::string> key_types = key_len_types;
+    if (key_types.empty() && !run_all && !run_default) {
+        key_types.push_back(key_type);
+    }
+    for (const auto& type : key_types) {
+        KeySpec spec = key_shape;
+        if (type.rfind("str:", 0) != 0) {
+            continue;
+        }
+        if (!parse_key_spec(type, spec)) {
+            std::cerr << "Invalid key type " << type << " (str:LEN or str:MIN-MAX)\n";
+            return 1;
+        }
+        size_t shortest = min_key_length(spec, 1ULL << num_power);
+        if (spec.min_len < shortest) {
+            std::cerr << "Key type " << type << " is too short: 2^" << num_power << " unique keys with a "
+                      << spec.prefix_len << "-character prefix need at least " << shortest << " characters\n";
+            return 1;
+        }
+    }
+    
+    // Load the baseline up front so a bad path fails before the run
+    std::vector<BenchmarkResult> baseline_results;
+    if (!baseline_path.empty()) {
+        std::string error;
+        if (!load_results_jsonl(baseline_path, baseline_results, error)) {
+            std::cerr << "Cannot load baseline: " << error << "\n";
+            return 1;
+        }
+    }
+    
+    // --output alone picks the format from the file extension
+    if (!output_path.empty() && !format_set) {
+        bool csv = output_path.size() >= 4 && output_path.compare(output_path.size() - 4, 4, ".csv") == 0;
+        output_format = csv ? OutputFormat::Csv : OutputFormat::Jsonl;
+    }
+    if (!output_path.empty() && output_format == OutputFormat::Table) {
+        std::cerr << "--output needs --format=csv or --format=jsonl\n";
+        return 1;
+    }
+    
+    // Records go to the --output file, or to stdout in place of the tables
+    std::ofstream output_file;
+    std::ostream records(std::cout.rdbuf());
+    std::optional<SilenceStdout> silence_tables;
+    if (output_format != OutputFormat::Table) {
+        if (!output_path.empty()) {
+            output_file.open(output_path);
+            if (!output_file) {
+                std::cerr << "Cannot open " << output_path << " for writing\n";
+                return 1;
+            }
+            records.rdbuf(output_file.rdbuf());
+        } else {
+            silence_tables.emplace();
+        }
+    }
+    
+    // Reject -i patterns that name nothing rather than silently running no benchmark
+    if (!impl_filter.empty()) {
+        std::stringstream ss(impl_filter);
+        std::string pattern;
+        while (std::getline(ss, pattern, ',')) {
+            bool known = false;
+            auto check = [&](const auto& entry) {
+                known = known || impl_matches(pattern, entry.name, entry.display_name);
+            };
+            for_each_impl(kImplementations, check);
+            for_each_impl(kConcurrentImplementations, check);
+            if (!pattern.empty() && !known) {
+                std::cerr << "Unknown implementation: " << pattern << " (see -h)\n";
+                return 1;
+            }
+        }
+    }
+    
     LOG_DEBUG( "Parameters: num_power=%d, key_type=%s, repeat=%d, pause=%u",
              num_power, key_type.c_str(), repeat, pause);
     
-    std::cout << "hashmap_bench - Hash Map Performance Benchmark\n";
-    std::cout << "Elements: 2^" << num_power << " = " << (1ULL << num_power) << "\n";
-    std::cout << "Repetitions: " << repeat << "\n\n";
+    Clock::init(clock_source);
     
-    std::vector<BenchmarkResult> all_results;
+    std::cout << "hashmap_bench - Hash Map Performance Benchmark\n";
+    if (trace_loaded) {
+        size_t distinct = replay_trace.int_keyed ? replay_trace.int_keys.size() : replay_trace.keys.size();
+        std::cout << "Elements: " << distinct << " distinct keys, " << replay_trace.workload.ops.size()
+                  << " ops in " << trace_file << " (latency sampled every " << latency_sample_every << " ops)\n";
+    } else if (corpus_keys > 0) {
+        std::cout << "Elements: " << corpus_keys << " of " << key_corpus.size() << " keys in " << keys_file
+                  << " (" << key_file_format_name(key_corpus.format()) << ", " << std::fixed << std::setprecision(1)
+                  << key_corpus.mapped_bytes() / (1024.0 * 1024.0) << " MB mapped)\n";
+    } else {
+        std::cout << "Elements: 2^" << num_power << " = " << (1ULL << num_power) << "\n";
+    }
+    if (target_ci > 0) {
+        std::cout << "Repetitions: until 95% CI < " << target_ci * 100 << "% of the mean (max "
+                  << (repeat_set ? repeat : 30) << ")";
+    } else {
+        std::cout << "Repetitions: " << repeat;
+    }
+    if (warmup > 0) {
+        std::cout << " (+" << warmup << " warmup)";
+    }
+    std::cout << "\n";
+    std::cout << "Clock: " << Clock::source_name();
+    if (Clock::source() == ClockSource::Tsc) {
+        std::cout << " (" << std::fixed << std::setprecision(3) << 1.0 / Clock::ns_per_tick()
+                  << " GHz, calibrated against CLOCK_MONOTONIC_RAW)";
+    } else if (clock_source == ClockSource::Tsc) {
+        std::cout << " (no invariant TSC)";
+    }
+    std::cout << ", read overhead " << std::fixed << std::setprecision(1) << Clock::overhead_ns()
+              << " ns (subtracted from every interval)\n";
+    if (num_threads > 1) {
+        std::cout << "Threads: " << num_threads << "\n";
+    }
+    if (numa_node >= 0 || mem_policy != MemPolicy::Default || query_node >= 0) {
+        std::cout << "NUMA: " << numa_num_nodes() << " node(s), threads on "
+                  << (numa_node >= 0 ? "node " + std::to_string(numa_node) : std::string("any node"));
+        if (mem_policy != MemPolicy::Default) {
+            std::cout << ", memory " << (mem_policy == MemPolicy::Bind ? "bound to" : "interleaved over")
+                      << " node(s) " << format_node_list(mem_nodes);
+        }
+        if (query_node >= 0 && num_threads == 1) {
+            std::cout << ", queries repeated from node " << query_node;
+        }
+        std::cout << "\n";
+    }
+    if (hugepage_mode() != HugePageMode::Off) {
+        std::cout << "Huge pages: " << hugepage_mode_name(hugepage_mode())
+                  << " for C++ container arrays of 2 MB and up; CLHT/ssmem "
+                  << (SSMEM_TRANSPARENT_HUGE_PAGES ? "built with" : "built without")
+                  << " SSMEM_TRANSPARENT_HUGE_PAGES\n";
+    }
+    if (batch_size > 0 && num_threads == 1) {
+        std::cout << "Batch: " << batch_size << " keys per call\n";
+    }
+    if (!reserve_capacity) {
+        std::cout << "Capacity: maps start empty (--no-reserve), resizes traced where reported\n";
+    }
+    if (scattered_keys) {
+        std::cout << "String keys: generated std::string objects, not the key store (--scattered-keys)\n";
+    }
+    if (!key_len_types.empty() || key_type.rfind("str:", 0) == 0) {
+        std::cout << "String keys: " << key_shape.alphabet.size() << "-character alphabet, "
+                  << key_shape.prefix_len << "-character common prefix";
+        if (!key_len_types.empty()) {
+            std::cout << ", lengths " << key_len_types.front().substr(4) << " to " << key_len_types.back().substr(4);
+        }
+        std::cout << "\n";
+    }
+    if (!load_factors.empty()) {
+        std::cout << "Load factor sweep: " << load_factors.size() << " points from "
+                  << std::setprecision(2) << load_factors.front() << " to " << load_factors.back() << "\n";
+    }
+    std::cout << "\n";
     
-    for (int i = 0; i < repeat; i++) {
-        std::cout << "\n=== Repetition " << (i + 1) << "/" << repeat << " ===\n";
-        
-        if (run_all) {
+    auto run_suite = [&]() {
+        std::vector<BenchmarkResult> results;
+        auto append = [&results](const std::vector<BenchmarkResult>& more) {
+            results.insert(results.end(), more.begin(), more.end());
+        };
+        if (!key_len_types.empty()) {
+            for (const auto& type : key_len_types) {
+                append(run_all_string_benchmarks(type, num_power, run_all_impls));
+            }
+        } else if (run_all) {
             // Run all key types
-            auto short_results = run_all_string_benchmarks("short_string", num_power, run_all_impls);
-            all_results.insert(all_results.end(), short_results.begin(), short_results.end());
-            
-            auto mid_results = run_all_string_benchmarks("mid_string", num_power, run_all_impls);
-            all_results.insert(all_results.end(), mid_results.begin(), mid_results.end());
-            
-            auto long_results = run_all_string_benchmarks("long_string", num_power, run_all_impls);
-            all_results.insert(all_results.end(), long_results.begin(), long_results.end());
-            
-            auto int_results = run_all_int_benchmarks(num_power, run_all_impls);
-            all_results.insert(all_results.end(), int_results.begin(), int_results.end());
+            append(run_all_string_benchmarks("short_string", num_power, run_all_impls));
+            append(run_all_string_benchmarks("mid_string", num_power, run_all_impls));
+            append(run_all_string_benchmarks("long_string", num_power, run_all_impls));
+            append(run_all_int_benchmarks(num_power, run_all_impls));
         } else if (run_default) {
             // -n mode: run short_string + int
-            auto short_results = run_all_string_benchmarks("short_string", num_power, run_all_impls);
-            all_results.insert(all_results.end(), short_results.begin(), short_results.end());
-            
-            auto int_results = run_all_int_benchmarks(num_power, run_all_impls);
-            all_results.insert(all_results.end(), int_results.begin(), int_results.end());
+            append(run_all_string_benchmarks("short_string", num_power, run_all_impls));
+            append(run_all_int_benchmarks(num_power, run_all_impls));
         } else if (key_type == "int") {
-            auto results = run_all_int_benchmarks(num_power, run_all_impls);
-            all_results.insert(all_results.end(), results.begin(), results.end());
+            append(run_all_int_benchmarks(num_power, run_all_impls));
         } else {
-            auto results = run_all_string_benchmarks(key_type, num_power, run_all_impls);
-            all_results.insert(all_results.end(), results.begin(), results.end());
+            append(run_all_string_benchmarks(key_type, num_power, run_all_impls));
+        }
+        return results;
+    };
+    
+    auto run_repetition = [&]() {
+        if (load_factors.empty()) {
+            return run_suite();
+        }
+        std::vector<BenchmarkResult> results;
+        for (double load_factor : load_factors) {
+            std::cout << "\n--- Load factor " << std::fixed << std::setprecision(2) << load_factor << " ---\n";
+            target_load_factor = load_factor;
+            auto point = run_suite();
+            results.insert(results.end(), point.begin(), point.end());
+        }
+        target_load_factor = 0;
+        return results;
+    };
+    
+    // Warmup repetitions fault in the allocator and caches; their output is dropped
+    for (int i = 0; i < warmup; i++) {
+        std::cout << "=== Warmup " << (i + 1) << "/" << warmup << " ===\n" << std::flush;
+        SilenceStdout silence;
+        run_repetition();
+    }
+    
+    // --target-ci keeps repeating, up to -r times (30 by default), until every
+    // insert and query mean is known to within the requested relative CI
+    int max_repeat = target_ci > 0 && !repeat_set ? 30 : repeat;
+    std::vector<BenchmarkResult> all_results;
+    int completed = 0;
+    
+    for (int i = 0; i < max_repeat; i++) {
+        std::cout << "\n=== Repetition " << (i + 1) << "/" << max_repeat << " ===\n";
+        
+        auto results = run_repetition();
+        for (auto& result : results) {
+            result.repetition = i + 1;
+        }
+        all_results.insert(all_results.end(), results.begin(), results.end());
+        completed++;
+        
+        if (target_ci > 0 && completed >= 3) {
+            auto aggregates = aggregate_results(all_results);
+            bool converged = std::all_of(aggregates.begin(), aggregates.end(), [target_ci](const AggregateResult& a) {
+                return a.insert_mops.relative_ci() <= target_ci && a.query_mops.relative_ci() <= target_ci;
+            });
+            if (converged) {
+                std::cout << "\nConverged: every 95% CI within " << target_ci * 100
+                          << "% of the mean after " << completed << " repetitions\n";
+                break;
+            }
         }
         
         if (pause > 0) {
@@ -509,9 +1663,51 @@ int main(int argc, char* argv[]) {
         }
     }
     
+    if (completed > 1) {
+        print_summary(aggregate_results(all_results));
+    }
+    if (!load_factors.empty()) {
+        print_load_factor_sweep(aggregate_results(all_results));
+    }
+    if (!key_len_types.empty()) {
+        print_key_length_sweep(aggregate_results(all_results), key_len_types);
+    }
+    
+    if (output_format != OutputFormat::Table) {
+        RunMetadata metadata = collect_run_metadata();
+        metadata.num_power = num_power;
+        metadata.seed = seed;
+        write_results(records, output_format, all_results, metadata);
+        if (!output_path.empty()) {
+            std::cout << "\nWrote " << all_results.size() << " records to " << output_path << "\n";
+        }
+    }
+    
+    int exit_code = 0;
+    if (!baseline_path.empty()) {
+        auto comparisons = compare_results(aggregate_results(baseline_results),
+                                           aggregate_results(all_results), regression_threshold);
+        print_comparison(comparisons, baseline_path, regression_threshold);
+        if (std::any_of(comparisons.begin(), comparisons.end(), [](const Comparison& c) { return c.regression; })) {
+            std::cerr << "Performance regression against " << baseline_path << "\n";
+            exit_code = 2;
+        }
+    }
+    
+    if (hugepage_mode() != HugePageMode::Off) {
+        HugePageStats stats = hugepage_stats();
+        std::cout << "\nHuge page blocks: " << stats.thp_blocks << " thp, " << stats.hugetlb_blocks
+                  << " hugetlb";
+        if (stats.hugetlb_fallbacks > 0) {
+            std::cout << " (" << stats.hugetlb_fallbacks
+                      << " MAP_HUGETLB failures fell back to thp; reserve vm.nr_hugepages)";
+        }
+        std::cout << "\n";
+    }
+    
     std::cout << "\nSide effect (anti-optimization): " << side_effect << "\n";
     
     LOG_DEBUG( "Benchmark completed. Side effect: %lu", side_effect);
     
-    return 0;
+    return exit_code;
 }
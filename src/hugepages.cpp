@@ -0,0 +1,168 @@
+#include "hugepages.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+
+#include <sys/mman.h>
+
+#include "memory_tracker.hpp"
+
+namespace hashmap_bench {
+
+namespace {
+
+std::atomic<HugePageMode> current_mode{HugePageMode::Off};
+
+std::atomic<size_t> thp_blocks{0};
+std::atomic<size_t> hugetlb_blocks{0};
+std::atomic<size_t> hugetlb_fallbacks{0};
+
+// Live MAP_HUGETLB blocks and their mapped length; everything else large
+// came from aligned_alloc
+std::mutex hugetlb_mutex;
+std::unordered_map<void*, size_t> hugetlb_mappings;
+size_t hugetlb_mapped_bytes = 0;
+
+size_t round_to_huge_page(size_t bytes) {
+    return (bytes + kHugePageSize - 1) & ~(kHugePageSize - 1);
+}
+
+// Advice must precede the first touch, or the range is faulted in with
+// small pages and only khugepaged can collapse it later
+void* thp_allocate(size_t bytes) {
+    size_t length = round_to_huge_page(bytes);
+    void* ptr = aligned_alloc(kHugePageSize, length);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    madvise(ptr, length, MADV_HUGEPAGE);
+    thp_blocks.fetch_add(1, std::memory_order_relaxed);
+    return ptr;
+}
+
+void* hugetlb_allocate(size_t bytes) {
+    size_t length = round_to_huge_page(bytes);
+    void* ptr = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (ptr == MAP_FAILED) {
+        // Pool empty or not configured (vm.nr_hugepages)
+        hugetlb_fallbacks.fetch_add(1, std::memory_order_relaxed);
+        return thp_allocate(bytes);
+    }
+    {
+        std::lock_guard<std::mutex> lock(hugetlb_mutex);
+        hugetlb_mappings.emplace(ptr, length);
+        hugetlb_mapped_bytes += length;
+    }
+    memory_track_mapping(length);
+    hugetlb_blocks.fetch_add(1, std::memory_order_relaxed);
+    return ptr;
+}
+
+// Returns false when ptr is not a MAP_HUGETLB block
+bool hugetlb_deallocate(void* ptr) {
+    size_t length;
+    {
+        std::lock_guard<std::mutex> lock(hugetlb_mutex);
+        auto it = hugetlb_mappings.find(ptr);
+        if (it == hugetlb_mappings.end()) {
+            return false;
+        }
+        length = it->second;
+        hugetlb_mapped_bytes -= length;
+        hugetlb_mappings.erase(it);
+    }
+    munmap(ptr, length);
+    memory_untrack_mapping(length);
+    return true;
+}
+
+} // namespace
+
+bool parse_hugepage_mode(const std::string& text, HugePageMode& mode) {
+    if (text == "off") {
+        mode = HugePageMode::Off;
+    } else if (text == "thp") {
+        mode = HugePageMode::Thp;
+    } else if (text == "hugetlb") {
+        mode = HugePageMode::Hugetlb;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* hugepage_mode_name(HugePageMode mode) {
+    switch (mode) {
+        case HugePageMode::Thp: return "thp";
+        case HugePageMode::Hugetlb: return "hugetlb";
+        default: return "off";
+    }
+}
+
+void set_hugepage_mode(HugePageMode mode) {
+    current_mode.store(mode, std::memory_order_relaxed);
+}
+
+HugePageMode hugepage_mode() {
+    return current_mode.load(std::memory_order_relaxed);
+}
+
+void* hugepage_allocate(size_t bytes, size_t alignment) {
+    HugePageMode mode = hugepage_mode();
+    if (mode == HugePageMode::Off || bytes < kHugePageSize) {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            return ::operator new(bytes, std::align_val_t(alignment));
+        }
+        return ::operator new(bytes);
+    }
+    return mode == HugePageMode::Hugetlb ? hugetlb_allocate(bytes) : thp_allocate(bytes);
+}
+
+void hugepage_deallocate(void* ptr, size_t bytes, size_t alignment) noexcept {
+    HugePageMode mode = hugepage_mode();
+    if (mode == HugePageMode::Off || bytes < kHugePageSize) {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            ::operator delete(ptr, std::align_val_t(alignment));
+        } else {
+            ::operator delete(ptr);
+        }
+        return;
+    }
+    if (mode == HugePageMode::Hugetlb && hugetlb_deallocate(ptr)) {
+        return;
+    }
+    free(ptr);
+}
+
+HugePageStats hugepage_stats() {
+    HugePageStats stats;
+    stats.thp_blocks = thp_blocks.load(std::memory_order_relaxed);
+    stats.hugetlb_blocks = hugetlb_blocks.load(std::memory_order_relaxed);
+    stats.hugetlb_fallbacks = hugetlb_fallbacks.load(std::memory_order_relaxed);
+    return stats;
+}
+
+size_t hugepage_resident_bytes() {
+    size_t bytes = 0;
+    std::ifstream in("/proc/self/smaps_rollup");
+    std::string field;
+    while (in >> field) {
+        if (field == "AnonHugePages:") {
+            size_t kb = 0;
+            in >> kb;
+            bytes = kb * 1024;
+            break;
+        }
+        in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    std::lock_guard<std::mutex> lock(hugetlb_mutex);
+    return bytes + hugetlb_mapped_bytes;
+}
+
+} // namespace hashmap_bench
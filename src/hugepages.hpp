@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace hashmap_bench {
+
+// Huge page backing for container storage (--hugepages). Blocks of at least
+// kHugePageSize bytes -- bucket, slot and element arrays -- are placed on
+// 2 MiB boundaries and either advised with MADV_HUGEPAGE (thp) or mapped
+// from the hugetlbfs pool with MAP_HUGETLB (hugetlb, falling back to thp
+// when the pool is empty). Smaller blocks and mode off use operator new.
+
+enum class HugePageMode {
+    Off,
+    Thp,
+    Hugetlb,
+};
+
+constexpr size_t kHugePageSize = size_t{2} << 20;
+
+// off, thp or hugetlb
+bool parse_hugepage_mode(const std::string& text, HugePageMode& mode);
+const char* hugepage_mode_name(HugePageMode mode);
+
+// Set once before the first map is created; blocks are released by the path
+// that allocated them, so changing the mode with maps alive is not supported
+void set_hugepage_mode(HugePageMode mode);
+HugePageMode hugepage_mode();
+
+void* hugepage_allocate(size_t bytes, size_t alignment);
+void hugepage_deallocate(void* ptr, size_t bytes, size_t alignment) noexcept;
+
+// Blocks that went through each path since startup
+struct HugePageStats {
+    size_t thp_blocks = 0;
+    size_t hugetlb_blocks = 0;
+    size_t hugetlb_fallbacks = 0;  // MAP_HUGETLB failed, served as thp
+};
+
+HugePageStats hugepage_stats();
+
+// Bytes of this process currently backed by huge pages: AnonHugePages from
+// /proc/self/smaps_rollup plus the live MAP_HUGETLB blocks
+size_t hugepage_resident_bytes();
+
+// Stateless allocator for the C++ containers in hash_maps.hpp. Carries the
+// pre-C++11 members as well, which sparsehash still reads.
+template <typename T>
+class HugePageAllocator {
+public:
+    using value_type = T;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+    template <typename U>
+    struct rebind {
+        using other = HugePageAllocator<U>;
+    };
+
+    HugePageAllocator() noexcept = default;
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U>&) noexcept {}
+
+    // Blocks below kHugePageSize -- every node and small array -- go to
+    // std::allocator inline, so with --hugepages off only the rare large
+    // arrays pay the out-of-line call and mode check
+    T* allocate(size_t n) {
+        if (n * sizeof(T) < kHugePageSize) {
+            return std::allocator<T>().allocate(n);
+        }
+        return static_cast<T*>(hugepage_allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* ptr, size_t n) noexcept {
+        if (n * sizeof(T) < kHugePageSize) {
+            std::allocator<T>().deallocate(ptr, n);
+            return;
+        }
+        hugepage_deallocate(ptr, n * sizeof(T), alignof(T));
+    }
+    size_t max_size() const noexcept { return size_t(-1) / sizeof(T); }
+
+    template <typename U>
+    bool operator==(const HugePageAllocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const HugePageAllocator<U>&) const noexcept { return false; }
+};
+
+} // namespace hashmap_bench
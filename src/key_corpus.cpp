@@ -0,0 +1,193 @@
+#include "key_corpus.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace hashmap_bench {
+
+const char* key_file_format_name(KeyFileFormat format) {
+    switch (format) {
+        case KeyFileFormat::Binary: return "length-prefixed";
+        case KeyFileFormat::Ints: return "int64";
+        default: return "lines";
+    }
+}
+
+bool MappedFile::open(const std::string& path, std::string& error) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = path + ": " + strerror(errno);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        error = path + ": " + strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    if (st.st_size == 0) {
+        ::close(fd);
+        return true;
+    }
+    void* ptr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (ptr == MAP_FAILED) {
+        error = path + ": mmap failed: " + strerror(errno);
+        return false;
+    }
+    // Indexing reads the file front to back once
+    madvise(ptr, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+    data_ = static_cast<const char*>(ptr);
+    size_ = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_ != nullptr) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+}
+
+bool KeyCorpus::open(const std::string& path, std::string& error) {
+    views_.clear();
+    ints_ = nullptr;
+    num_ints_ = 0;
+    if (!file_.open(path, error)) {
+        return false;
+    }
+
+    bool indexed;
+    const char* data = file_.data();
+    size_t bytes = file_.size();
+    if (bytes >= kKeyFileMagicSize && memcmp(data, kIntFileMagic, kKeyFileMagicSize) == 0) {
+        format_ = KeyFileFormat::Ints;
+        // The mapping is page aligned, so the keys after the magic are too
+        indexed = (bytes - kKeyFileMagicSize) % sizeof(uint64_t) == 0;
+        if (indexed) {
+            ints_ = reinterpret_cast<const uint64_t*>(data + kKeyFileMagicSize);
+            num_ints_ = (bytes - kKeyFileMagicSize) / sizeof(uint64_t);
+            indexed = check_ints(error);
+        } else {
+            error = "size is not a whole number of 8-byte keys";
+        }
+    } else if (bytes >= kKeyFileMagicSize && memcmp(data, kKeyFileMagic, kKeyFileMagicSize) == 0) {
+        format_ = KeyFileFormat::Binary;
+        indexed = index_records(error);
+    } else {
+        format_ = KeyFileFormat::Lines;
+        indexed = index_lines(error);
+    }
+    if (indexed && size() == 0) {
+        error = "no keys";
+        indexed = false;
+    }
+    if (!indexed) {
+        error = path + ": " + error;
+        file_.close();
+        views_.clear();
+        num_ints_ = 0;
+    }
+    return indexed;
+}
+
+static std::string reserved_key_error(size_t index) {
+    return "key " + std::to_string(index) + " is an empty or deleted marker of dense/sparse_hash_map";
+}
+
+bool KeyCorpus::index_lines(std::string& error) {
+    const char* pos = file_.data();
+    const char* end = pos + file_.size();
+    while (pos < end) {
+        const char* newline = static_cast<const char*>(memchr(pos, '\n', end - pos));
+        const char* line_end = newline != nullptr ? newline : end;
+        size_t len = line_end - pos;
+        if (len > 0 && pos[len - 1] == '\r') {
+            len--;
+        }
+        if (len > 0) {
+            if (is_reserved_key(std::string_view(pos, len))) {
+                error = reserved_key_error(views_.size());
+                return false;
+            }
+            views_.emplace_back(pos, len);
+        }
+        pos = line_end + 1;
+    }
+    return true;
+}
+
+bool KeyCorpus::index_records(std::string& error) {
+    const char* data = file_.data();
+    size_t bytes = file_.size();
+    size_t offset = kKeyFileMagicSize;
+    while (offset < bytes) {
+        uint32_t len;
+        if (bytes - offset < sizeof(len)) {
+            error = "truncated length at offset " + std::to_string(offset);
+            return false;
+        }
+        memcpy(&len, data + offset, sizeof(len));
+        offset += sizeof(len);
+        if (bytes - offset < len) {
+            error = "record at offset " + std::to_string(offset - sizeof(len)) + " runs past the end";
+            return false;
+        }
+        if (is_reserved_key(std::string_view(data + offset, len))) {
+            error = reserved_key_error(views_.size());
+            return false;
+        }
+        views_.emplace_back(data + offset, len);
+        offset += len;
+    }
+    return true;
+}
+
+bool KeyCorpus::check_ints(std::string& error) const {
+    for (size_t i = 0; i < num_ints_; i++) {
+        if (is_reserved_key(ints_[i])) {
+            error = reserved_key_error(i);
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t KeyCorpus::count_duplicates(size_t n) const {
+    auto count = [](auto& sorted) {
+        std::sort(sorted.begin(), sorted.end());
+        size_t duplicates = 0;
+        for (size_t i = 1; i < sorted.size(); i++) {
+            duplicates += sorted[i] == sorted[i - 1];
+        }
+        return duplicates;
+    };
+    if (is_int()) {
+        std::vector<uint64_t> sorted(ints_, ints_ + n);
+        return count(sorted);
+    }
+    std::vector<std::string_view> sorted(views_.begin(), views_.begin() + n);
+    return count(sorted);
+}
+
+void KeyCorpus::copy_keys(std::vector<std::string>& keys, size_t n) const {
+    keys.clear();
+    keys.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        keys.emplace_back(views_[i]);
+    }
+}
+
+void KeyCorpus::copy_keys(std::vector<uint64_t>& keys, size_t n) const {
+    keys.assign(ints_, ints_ + n);
+}
+
+} // namespace hashmap_bench
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hashmap_bench {
+
+// On-disk key corpora (--keys-file). The file is mapped read-only and the
+// keys are indexed in place, so a sample of hundreds of millions of
+// production keys needs no parse step beyond finding the record boundaries.
+// Formats, told apart by the first 8 bytes:
+//   HMBKEYS1  records of a little-endian uint32 length and that many bytes
+//   HMBINTS1  little-endian uint64 keys up to the end of the file
+//   other     one key per line; a trailing \r is dropped, empty lines skipped
+// Keys must be unique, since the benchmark phases insert every key once and
+// expect the map to hold all of them; count_duplicates() checks the ones a
+// run uses. Keys the dense/sparse_hash_map wrappers reserve as markers make
+// open() fail.
+
+enum class KeyFileFormat {
+    Lines,
+    Binary,
+    Ints,
+};
+
+inline constexpr char kKeyFileMagic[] = "HMBKEYS1";
+inline constexpr char kIntFileMagic[] = "HMBINTS1";
+inline constexpr size_t kKeyFileMagicSize = 8;
+
+const char* key_file_format_name(KeyFileFormat format);
+
+// The empty and deleted markers of the dense/sparse_hash_map wrappers: ~0 and
+// ~0 - 1 for integer keys, "" and "\xff" for strings. Neither map can hold them.
+inline bool is_reserved_key(uint64_t key) { return key >= ~uint64_t{0} - 1; }
+inline bool is_reserved_key(std::string_view key) { return key.empty() || key == "\xff"; }
+
+// A read-only private mapping of a whole file, advised MADV_SEQUENTIAL
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // False with a message in error when the file cannot be opened or mapped
+    bool open(const std::string& path, std::string& error);
+    void close();
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+class KeyCorpus {
+public:
+    // Map path and index its keys; false with a message in error for an
+    // unreadable, truncated or empty file
+    bool open(const std::string& path, std::string& error);
+
+    KeyFileFormat format() const { return format_; }
+    bool is_int() const { return format_ == KeyFileFormat::Ints; }
+    size_t size() const { return is_int() ? num_ints_ : views_.size(); }
+    size_t mapped_bytes() const { return file_.size(); }
+
+    // Views into the mapping; valid while the corpus is alive
+    std::string_view key(size_t i) const { return views_[i]; }
+    const std::string_view* keys() const { return views_.data(); }
+    uint64_t int_key(size_t i) const { return ints_[i]; }
+
+    // Keys among the first n equal to an earlier one; sorts a copy of their
+    // views or values, so it runs once before anything is timed
+    size_t count_duplicates(size_t n) const;
+
+    // Copies of the first n keys in the containers the benchmarks take
+    void copy_keys(std::vector<std::string>& keys, size_t n) const;
+    void copy_keys(std::vector<uint64_t>& keys, size_t n) const;
+
+private:
+    bool index_lines(std::string& error);
+    bool index_records(std::string& error);
+    bool check_ints(std::string& error) const;
+
+    MappedFile file_;
+    KeyFileFormat format_ = KeyFileFormat::Lines;
+    std::vector<std::string_view> views_;
+    const uint64_t* ints_ = nullptr;
+    size_t num_ints_ = 0;
+};
+
+} // namespace hashmap_bench
@@ -0,0 +1,212 @@
+#include "memory_tracker.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+#include <malloc.h>
+
+// glibc's real allocator entry points
+extern "C" {
+void* __libc_malloc(size_t size);
+void __libc_free(void* ptr);
+void* __libc_calloc(size_t num, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+}
+
+namespace {
+
+// Constant-initialized, so the hook works before static constructors run.
+// live_bytes is signed: a pass may free blocks it never counted.
+std::atomic<bool> tracking{false};
+std::atomic<long long> live_bytes{0};
+std::atomic<long long> peak_bytes{0};
+
+inline bool tracking_enabled() {
+    return tracking.load(std::memory_order_relaxed);
+}
+
+inline void add_live(size_t size) {
+    long long live = live_bytes.fetch_add(static_cast<long long>(size), std::memory_order_relaxed)
+        + static_cast<long long>(size);
+    long long peak = peak_bytes.load(std::memory_order_relaxed);
+    while (live > peak && !peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+inline void sub_live(size_t size) {
+    live_bytes.fetch_sub(static_cast<long long>(size), std::memory_order_relaxed);
+}
+
+inline void track_alloc(void* ptr) {
+    if (ptr != nullptr && tracking_enabled()) {
+        add_live(malloc_usable_size(ptr));
+    }
+}
+
+inline void track_free(void* ptr) {
+    if (ptr != nullptr && tracking_enabled()) {
+        sub_live(malloc_usable_size(ptr));
+    }
+}
+
+inline size_t clamp_bytes(long long bytes) {
+    return bytes > 0 ? static_cast<size_t>(bytes) : 0;
+}
+
+inline void* aligned_malloc(size_t alignment, size_t size) {
+    void* ptr = __libc_memalign(alignment, size);
+    track_alloc(ptr);
+    return ptr;
+}
+
+void* new_impl(size_t size) {
+    if (size == 0) {
+        size = 1;
+    }
+    void* ptr;
+    while ((ptr = malloc(size)) == nullptr) {
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+    return ptr;
+}
+
+void* aligned_new_impl(size_t size, std::align_val_t alignment) {
+    if (size == 0) {
+        size = 1;
+    }
+    void* ptr;
+    while ((ptr = aligned_malloc(static_cast<size_t>(alignment), size)) == nullptr) {
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+    return ptr;
+}
+
+} // namespace
+
+namespace hashmap_bench {
+
+void memory_tracking_start() {
+    live_bytes.store(0, std::memory_order_relaxed);
+    peak_bytes.store(0, std::memory_order_relaxed);
+    tracking.store(true, std::memory_order_relaxed);
+}
+
+void memory_tracking_stop() {
+    tracking.store(false, std::memory_order_relaxed);
+}
+
+size_t memory_live_bytes() {
+    return clamp_bytes(live_bytes.load(std::memory_order_relaxed));
+}
+
+size_t memory_peak_bytes() {
+    return clamp_bytes(peak_bytes.load(std::memory_order_relaxed));
+}
+
+void memory_track_mapping(size_t bytes) {
+    if (tracking_enabled()) {
+        add_live(bytes);
+    }
+}
+
+void memory_untrack_mapping(size_t bytes) {
+    if (tracking_enabled()) {
+        sub_live(bytes);
+    }
+}
+
+} // namespace hashmap_bench
+
+// ============================================================================
+// malloc family interposition (covers the C libraries)
+// ============================================================================
+
+extern "C" {
+
+void* malloc(size_t size) {
+    void* ptr = __libc_malloc(size);
+    track_alloc(ptr);
+    return ptr;
+}
+
+void free(void* ptr) {
+    track_free(ptr);
+    __libc_free(ptr);
+}
+
+void* calloc(size_t num, size_t size) {
+    void* ptr = __libc_calloc(num, size);
+    track_alloc(ptr);
+    return ptr;
+}
+
+void* realloc(void* ptr, size_t size) {
+    if (!tracking_enabled()) {
+        return __libc_realloc(ptr, size);
+    }
+    size_t old_size = ptr != nullptr ? malloc_usable_size(ptr) : 0;
+    void* new_ptr = __libc_realloc(ptr, size);
+    if (new_ptr == nullptr && size != 0) {
+        return nullptr;  // old block untouched
+    }
+    sub_live(old_size);
+    track_alloc(new_ptr);
+    return new_ptr;
+}
+
+void* memalign(size_t alignment, size_t size) {
+    return aligned_malloc(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    return aligned_malloc(alignment, size);
+}
+
+int posix_memalign(void** out, size_t alignment, size_t size) {
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    void* ptr = aligned_malloc(alignment, size);
+    if (ptr == nullptr) {
+        return ENOMEM;
+    }
+    *out = ptr;
+    return 0;
+}
+
+void* valloc(size_t size) {
+    return aligned_malloc(4096, size);
+}
+
+} // extern "C"
+
+// ============================================================================
+// operator new/delete (routed through the counted malloc)
+// ============================================================================
+
+void* operator new(size_t size) { return new_impl(size); }
+void* operator new[](size_t size) { return new_impl(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return malloc(size ? size : 1); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return malloc(size ? size : 1); }
+void* operator new(size_t size, std::align_val_t al) { return aligned_new_impl(size, al); }
+void* operator new[](size_t size, std::align_val_t al) { return aligned_new_impl(size, al); }
+
+void operator delete(void* ptr) noexcept { free(ptr); }
+void operator delete[](void* ptr) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { free(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { free(ptr); }
+void operator delete(void* ptr, std::align_val_t) noexcept { free(ptr); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { free(ptr); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { free(ptr); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { free(ptr); }
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+
+namespace hashmap_bench {
+
+// Heap accounting fed by the counting allocator hook in memory_tracker.cpp.
+// operator new/delete and the malloc family (used directly by rhashmap, OPIC
+// and CLHT/ssmem) are interposed; every block is counted at its usable size.
+// mmap-backed storage (e.g. the OPIC heap file) is not visible to the hook.
+//
+// Counting is off unless a memory pass is open: outside one the hook costs a
+// single relaxed load per call, so timed phases run at plain malloc speed.
+// A pass is meant for one thread building one map; blocks freed inside it
+// that were allocated before it are not subtracted.
+
+// Open a memory pass: live and peak bytes restart from zero
+void memory_tracking_start();
+
+// Close the memory pass; live and peak keep their last values
+void memory_tracking_stop();
+
+// Bytes allocated and not yet freed since memory_tracking_start()
+size_t memory_live_bytes();
+
+// Highest live byte count since memory_tracking_start()
+size_t memory_peak_bytes();
+
+// Storage mapped outside malloc (MAP_HUGETLB blocks of the huge page
+// allocator), counted toward live and peak bytes like a heap block
+void memory_track_mapping(size_t bytes);
+void memory_untrack_mapping(size_t bytes);
+
+} // namespace hashmap_bench
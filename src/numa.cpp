@@ -0,0 +1,155 @@
+#include "numa.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "benchmark.hpp"
+
+namespace hashmap_bench {
+
+namespace {
+
+const char* const kNodeRoot = "/sys/devices/system/node";
+
+// Kernel list format: "0-3,8,10-11"
+bool parse_range_list(const std::string& text, std::vector<int>& values) {
+    values.clear();
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        item.erase(std::remove_if(item.begin(), item.end(), ::isspace), item.end());
+        if (item.empty()) {
+            continue;
+        }
+        size_t dash = item.find('-');
+        char* end = nullptr;
+        long first = strtol(item.c_str(), &end, 10);
+        long last = first;
+        if (dash != std::string::npos) {
+            if (end != item.c_str() + dash) {
+                return false;
+            }
+            last = strtol(item.c_str() + dash + 1, &end, 10);
+        }
+        if (*end != '\0' || first < 0 || last < first) {
+            return false;
+        }
+        for (long v = first; v <= last; v++) {
+            values.push_back(static_cast<int>(v));
+        }
+    }
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+    return !values.empty();
+}
+
+std::vector<int> online_nodes() {
+    std::ifstream in(std::string(kNodeRoot) + "/online");
+    std::string line;
+    std::vector<int> nodes;
+    if (!std::getline(in, line) || !parse_range_list(line, nodes)) {
+        nodes = {0};
+    }
+    return nodes;
+}
+
+} // namespace
+
+int numa_num_nodes() {
+    return online_nodes().back() + 1;
+}
+
+std::vector<int> numa_node_cpus(int node) {
+    std::vector<int> allowed = available_cpus();
+    std::ifstream in(std::string(kNodeRoot) + "/node" + std::to_string(node) + "/cpulist");
+    if (!in) {
+        // No sysfs topology: everything is node 0
+        return node == 0 && online_nodes() == std::vector<int>{0} ? allowed : std::vector<int>{};
+    }
+    std::string line;
+    std::vector<int> node_cpus;
+    if (!std::getline(in, line) || !parse_range_list(line, node_cpus)) {
+        return {};  // memory-only node
+    }
+    std::vector<int> cpus;
+    std::set_intersection(allowed.begin(), allowed.end(), node_cpus.begin(), node_cpus.end(),
+                          std::back_inserter(cpus));
+    return cpus;
+}
+
+bool parse_node_list(const std::string& text, std::vector<int>& nodes) {
+    std::vector<int> online = online_nodes();
+    if (text == "all") {
+        nodes = online;
+        return true;
+    }
+    if (!parse_range_list(text, nodes)) {
+        return false;
+    }
+    return std::all_of(nodes.begin(), nodes.end(), [&online](int node) {
+        return std::binary_search(online.begin(), online.end(), node);
+    });
+}
+
+bool numa_run_on_node(int node) {
+    std::vector<int> cpus = numa_node_cpus(node);
+    return !cpus.empty() && numa_run_on_cpus(cpus);
+}
+
+bool numa_run_on_cpus(const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return true;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &set);
+    }
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+bool numa_set_mempolicy(MemPolicy policy, const std::vector<int>& nodes) {
+    constexpr size_t kMaxNodes = 1024;
+    constexpr size_t kBitsPerWord = 8 * sizeof(unsigned long);
+    unsigned long mask[kMaxNodes / kBitsPerWord] = {};
+    for (int node : nodes) {
+        if (node < 0 || static_cast<size_t>(node) >= kMaxNodes) {
+            return false;
+        }
+        mask[node / kBitsPerWord] |= 1UL << (node % kBitsPerWord);
+    }
+
+    int mode = MPOL_DEFAULT;
+    switch (policy) {
+        case MemPolicy::Default: break;
+        case MemPolicy::Bind: mode = MPOL_BIND; break;
+        case MemPolicy::Interleave: mode = MPOL_INTERLEAVE; break;
+    }
+    if (mode == MPOL_DEFAULT) {
+        return syscall(SYS_set_mempolicy, mode, nullptr, 0) == 0;
+    }
+    // maxnode counts one past the last bit the kernel reads
+    return syscall(SYS_set_mempolicy, mode, mask, kMaxNodes + 1) == 0;
+}
+
+std::string format_node_list(const std::vector<int>& nodes) {
+    std::string text;
+    for (int node : nodes) {
+        if (!text.empty()) {
+            text += ",";
+        }
+        text += std::to_string(node);
+    }
+    return text;
+}
+
+} // namespace hashmap_bench
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace hashmap_bench {
+
+// NUMA placement (--numa-node, --mem-node, --interleave, --query-node) through
+// sched_setaffinity and the raw set_mempolicy syscall, so no libnuma is
+// needed. Topology comes from /sys/devices/system/node; a machine without it
+// is treated as a single node 0 holding every allowed CPU.
+
+enum class MemPolicy {
+    Default,     // first touch: pages land on the node of the faulting thread
+    Bind,        // only the given nodes
+    Interleave,  // round-robin page by page over the given nodes
+};
+
+// Number of possible node ids (highest online node + 1)
+int numa_num_nodes();
+
+// CPUs of node that the process may run on; empty for an unknown node
+std::vector<int> numa_node_cpus(int node);
+
+// "1", "0,1", "0-3" or "all"; false on syntax errors or nodes that do not exist
+bool parse_node_list(const std::string& text, std::vector<int>& nodes);
+
+// Restrict the calling thread to node's CPUs
+bool numa_run_on_node(int node);
+
+// Restrict the calling thread to cpus (empty leaves the affinity unchanged)
+bool numa_run_on_cpus(const std::vector<int>& cpus);
+
+// Memory policy of the calling thread for pages it faults in from now on;
+// threads it creates afterwards inherit it
+bool numa_set_mempolicy(MemPolicy policy, const std::vector<int>& nodes);
+
+// e.g. "0,1"
+std::string format_node_list(const std::vector<int>& nodes);
+
+} // namespace hashmap_bench
@@ -0,0 +1,225 @@
+#include "perf_counters.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace hashmap_bench {
+
+namespace {
+
+struct EventConfig {
+    uint32_t type;
+    uint64_t config;
+};
+
+constexpr uint64_t cache_read_miss(uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+// Indexed by PerfEvent
+constexpr EventConfig kEventConfigs[kNumPerfEvents] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, cache_read_miss(PERF_COUNT_HW_CACHE_L1D)},
+    {PERF_TYPE_HW_CACHE, cache_read_miss(PERF_COUNT_HW_CACHE_LL)},
+    {PERF_TYPE_HW_CACHE, cache_read_miss(PERF_COUNT_HW_CACHE_DTLB)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+const char* const kEventNames[kNumPerfEvents] = {
+    "cycles", "instructions", "L1D-miss", "LLC-miss", "dTLB-miss", "br-miss",
+};
+
+// Opens the group leader when leader is -1, else a member that starts and
+// stops with it
+int open_event(const EventConfig& event, int leader) {
+    struct perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.disabled = leader < 0 ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+}
+
+// nr, time_enabled, time_running, then one value per event of the group
+struct GroupRead {
+    uint64_t data[3 + kNumPerfEvents] = {};
+    size_t values = 0;  // 0 when the read failed or the group never ran
+
+    explicit GroupRead(int leader) {
+        ssize_t bytes = read(leader, data, sizeof(data));
+        if (bytes >= static_cast<ssize_t>(3 * sizeof(uint64_t)) && data[2] != 0) {
+            values = std::min<size_t>(data[0], static_cast<size_t>(bytes) / sizeof(uint64_t) - 3);
+        }
+    }
+    double scale() const { return static_cast<double>(data[1]) / static_cast<double>(data[2]); }
+};
+
+// Whether the kernel actually schedules the group: a short enabled window
+// must leave time_running above zero
+bool group_runs(int leader) {
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    volatile uint64_t spin = 0;
+    for (uint64_t i = 0; i < 100000; i++) {
+        spin = spin + i;
+    }
+    ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    return GroupRead(leader).values > 0;
+}
+
+std::string event_list(const std::vector<size_t>& events) {
+    std::string list;
+    for (size_t event : events) {
+        list += (list.empty() ? "" : ", ") + std::string(kEventNames[event]);
+    }
+    return list;
+}
+
+} // namespace
+
+const char* perf_event_name(PerfEvent event) {
+    return kEventNames[static_cast<size_t>(event)];
+}
+
+bool PerfCounts::any() const {
+    for (bool v : valid) {
+        if (v) {
+            return true;
+        }
+    }
+    return false;
+}
+
+PerfCounts PerfCounts::per_op(uint64_t ops) const {
+    PerfCounts result = *this;
+    if (ops == 0) {
+        return result;
+    }
+    for (double& value : result.values) {
+        value /= static_cast<double>(ops);
+    }
+    return result;
+}
+
+PerfCounters::PerfCounters() {
+    fds_.fill(-1);
+    std::vector<size_t> all;
+    for (size_t i = 0; i < kNumPerfEvents; i++) {
+        all.push_back(i);
+    }
+    Group group = open_group(all);
+    if (group.leader < 0) {
+        return;
+    }
+    if (group_runs(group.leader)) {
+        groups_.push_back(group);
+        return;
+    }
+    close_group(group);
+
+    // Split off the hardware-cache events, then run them one by one
+    std::vector<size_t> core;
+    std::vector<size_t> cache;
+    for (size_t i = 0; i < kNumPerfEvents; i++) {
+        (kEventConfigs[i].type == PERF_TYPE_HW_CACHE ? cache : core).push_back(i);
+    }
+    std::vector<size_t> dropped;
+    for (const std::vector<size_t>& events : {core, cache}) {
+        Group split = open_group(events);
+        if (split.leader >= 0 && group_runs(split.leader)) {
+            groups_.push_back(split);
+            continue;
+        }
+        close_group(split);
+        for (size_t event : events) {
+            Group single = open_group({event});
+            if (single.leader >= 0 && group_runs(single.leader)) {
+                groups_.push_back(single);
+            } else {
+                close_group(single);
+                dropped.push_back(event);
+            }
+        }
+    }
+
+    if (groups_.empty()) {
+        warning_ = "the PMU never scheduled any counter (the NMI watchdog or an SMT sibling may hold them)";
+        return;
+    }
+    warning_ = "the events do not fit one counter group, so they are counted in " + std::to_string(groups_.size())
+        + " groups and ratios across groups may mix multiplexing windows";
+    if (!dropped.empty()) {
+        warning_ += "; never scheduled, reported as missing: " + event_list(dropped);
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (const Group& group : groups_) {
+        close_group(group);
+    }
+}
+
+PerfCounters::Group PerfCounters::open_group(const std::vector<size_t>& events) {
+    Group group;
+    for (size_t event : events) {
+        int fd = open_event(kEventConfigs[event], group.leader);
+        if (fd < 0) {
+            continue;
+        }
+        if (group.leader < 0) {
+            group.leader = fd;
+        }
+        fds_[event] = fd;
+        group.events.push_back(event);
+    }
+    return group;
+}
+
+void PerfCounters::close_group(const Group& group) {
+    for (size_t event : group.events) {
+        close(fds_[event]);
+        fds_[event] = -1;
+    }
+}
+
+bool PerfCounters::available() const {
+    return !groups_.empty();
+}
+
+void PerfCounters::start() {
+    for (const Group& group : groups_) {
+        ioctl(group.leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(group.leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+}
+
+PerfCounts PerfCounters::stop() {
+    PerfCounts counts;
+    for (const Group& group : groups_) {
+        ioctl(group.leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+    for (const Group& group : groups_) {
+        GroupRead sample(group.leader);
+        size_t n = std::min(sample.values, group.events.size());
+        for (size_t slot = 0; slot < n; slot++) {
+            size_t event = group.events[slot];
+            counts.values[event] = static_cast<double>(sample.data[3 + slot]) * sample.scale();
+            counts.valid[event] = true;
+        }
+    }
+    return counts;
+}
+
+} // namespace hashmap_bench
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace hashmap_bench {
+
+// Hardware performance counters read through perf_event_open (--perf).
+// The events are opened for the calling thread, user space only, as one
+// group led by the first event that opens; an event the PMU or
+// perf_event_paranoid do not allow simply stays invalid. The kernel schedules
+// a group as a unit, so when it has to multiplex, every count is scaled by the
+// same time_enabled / time_running and ratios between events stay consistent.
+//
+// A group needing more general-purpose counters than are free (the NMI
+// watchdog or an SMT sibling holds some) is never scheduled at all. The
+// constructor probes for that and falls back to a core group plus a cache
+// group, then to independent cache events; events that still never run are
+// dropped. warning() describes any such fallback.
+
+enum class PerfEvent : uint8_t {
+    Cycles,
+    Instructions,
+    L1dMisses,
+    LlcMisses,
+    DtlbMisses,
+    BranchMisses,
+};
+
+constexpr size_t kNumPerfEvents = 6;
+
+// Short column label, e.g. "L1D-miss"
+const char* perf_event_name(PerfEvent event);
+
+struct PerfCounts {
+    std::array<double, kNumPerfEvents> values{};
+    std::array<bool, kNumPerfEvents> valid{};
+
+    bool any() const;
+    double operator[](PerfEvent event) const { return values[static_cast<size_t>(event)]; }
+    bool has(PerfEvent event) const { return valid[static_cast<size_t>(event)]; }
+
+    // Every count divided by ops
+    PerfCounts per_op(uint64_t ops) const;
+};
+
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // True when at least one event could be opened and scheduled
+    bool available() const;
+
+    // Empty unless the events had to be split or dropped
+    const std::string& warning() const { return warning_; }
+
+    // Reset and enable every group
+    void start();
+
+    // Disable and read every group; a group's events are invalid if it never
+    // ran in this window
+    PerfCounts stop();
+
+private:
+    struct Group {
+        int leader = -1;
+        std::vector<size_t> events;  // PerfEvent indices in join order
+    };
+
+    Group open_group(const std::vector<size_t>& events);
+    void close_group(const Group& group);
+
+    std::array<int, kNumPerfEvents> fds_;
+    std::vector<Group> groups_;
+    std::string warning_;
+};
+
+} // namespace hashmap_bench
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <fnmatch.h>
+
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+#include "hash_maps.hpp"
+
+namespace hashmap_bench {
+
+// ============================================================================
+// Implementation registry
+// ============================================================================
+
+// One benchmarked container. The wrapper types are void when the container
+// does not support that key type.
+template <typename StringWrapperT, typename IntWrapperT>
+struct ImplEntry {
+    using StringWrapper = StringWrapperT;
+    using IntWrapper = IntWrapperT;
+
+    const char* name;          // -i name, e.g. absl_flat_hash_map
+    const char* display_name;  // result table name, e.g. absl::flat_hash_map
+    bool ordered;
+    bool extended;             // runs only with -a unless selected by -i
+    const char* note;          // prefix for the comments column
+};
+
+template <template <typename, typename> class Wrapper>
+using BothKeys = ImplEntry<Wrapper<std::string, uint64_t>, Wrapper<uint64_t, uint64_t>>;
+
+// Single-threaded suite, in report order
+inline constexpr auto kImplementations = std::make_tuple(
+    // Unordered (hash) containers
+    BothKeys<StdUnorderedMapWrapper>{"std_unordered_map", "std::unordered_map", false, false, ""},
+    BothKeys<AbslFlatHashMapWrapper>{"absl_flat_hash_map", "absl::flat_hash_map", false, false, ""},
+    BothKeys<AbslNodeHashMapWrapper>{"absl_node_hash_map", "absl::node_hash_map", false, false, ""},
+    BothKeys<StdUnorderedMapMonotonicWrapper>{"std_unordered_map_monotonic", "std::unordered_map+mono", false, false, "pmr monotonic arena"},
+    BothKeys<StdUnorderedMapSlabWrapper>{"std_unordered_map_slab", "std::unordered_map+slab", false, false, "slab pool"},
+    BothKeys<AbslNodeHashMapMonotonicWrapper>{"absl_node_hash_map_monotonic", "absl::node_hash_map+mono", false, false, "pmr monotonic arena"},
+    BothKeys<AbslNodeHashMapSlabWrapper>{"absl_node_hash_map_slab", "absl::node_hash_map+slab", false, false, "slab pool"},
+    BothKeys<FollyF14FastMapWrapper>{"folly_F14FastMap", "folly::F14FastMap", false, false, ""},
+    BothKeys<DenseHashMapWrapper>{"dense_hash_map", "google::dense_hash_map", false, false, ""},
+    BothKeys<SparseHashMapWrapper>{"sparse_hash_map", "google::sparse_hash_map", false, false, ""},
+    ImplEntry<void, ClhtLbWrapper>{"CLHT_LB", "CLHT-LB", false, false, "✅ Lock-Based"},
+    ImplEntry<void, ClhtLfWrapper>{"CLHT_LF", "CLHT-LF", false, false, "✅ Lock-Free"},
+    BothKeys<CistaHashMapWrapper>{"cista_hash_map", "cista::hash_map", false, true, ""},
+    BothKeys<CuckooHashMapWrapper>{"cuckoohash_map", "libcuckoo::cuckoohash_map", false, true, ""},
+    ImplEntry<RhashmapWrapper, void>{"rhashmap", "rhashmap", false, true, ""},
+    ImplEntry<void, OpicRobinHoodWrapper>{"OPIC", "OPIC::robin_hood", false, true, ""},
+    BothKeys<PhmapFlatHashMapWrapper>{"phmap_flat", "phmap::flat_hash_map", false, true, ""},
+    BothKeys<PhmapParallelHashMapWrapper>{"phmap_parallel", "phmap::parallel_flat_hash_map", false, true, ""},
+    // Ordered containers
+    BothKeys<StdMapWrapper>{"std_map", "std::map", true, false, ""},
+    BothKeys<StdMapMonotonicWrapper>{"std_map_monotonic", "std::map+mono", true, false, "pmr monotonic arena"},
+    BothKeys<StdMapSlabWrapper>{"std_map_slab", "std::map+slab", true, false, "slab pool"},
+    BothKeys<AbslBtreeMapWrapper>{"absl_btree_map", "absl::btree_map", true, false, ""},
+    BothKeys<BoostFlatMapWrapper>{"boost_flat_map", "boost::flat_map", true, false, ""},
+    BothKeys<FollySortedVectorMapWrapper>{"folly_sorted_vector_map", "folly::sorted_vector_map", true, false, ""});
+
+// Thread-safe containers for the concurrent mode (-t)
+inline constexpr auto kConcurrentImplementations = std::make_tuple(
+    ImplEntry<void, ClhtLbWrapper>{"CLHT_LB", "CLHT-LB", false, false, "✅ Lock-Based"},
+    ImplEntry<void, ClhtLfWrapper>{"CLHT_LF", "CLHT-LF", false, false, "✅ Lock-Free"},
+    BothKeys<CuckooHashMapWrapper>{"cuckoohash_map", "libcuckoo::cuckoohash_map", false, false, ""},
+    BothKeys<PhmapParallelHashMapMtWrapper>{"phmap_parallel", "phmap::parallel_flat_hash_map", false, false, "std::mutex"});
+
+template <typename Registry, typename Fn>
+void for_each_impl(const Registry& registry, Fn&& fn) {
+    std::apply([&fn](const auto&... entry) { (fn(entry), ...); }, registry);
+}
+
+// Comments column: "<note>, KV: <key>/uintptr_t[, Ordered]"
+template <typename Entry>
+std::string impl_comment(const Entry& entry, const std::string& key_kind) {
+    std::string comment = entry.note;
+    if (!comment.empty()) {
+        comment += ", ";
+    }
+    comment += "KV: " + key_kind + "/uintptr_t";
+    if (entry.ordered) {
+        comment += ", Ordered";
+    }
+    return comment;
+}
+
+// filter is a comma-separated list of names or shell globs, matched against
+// both the -i name and the display name
+inline bool impl_matches(const std::string& filter, const char* name, const char* display_name) {
+    std::stringstream ss(filter);
+    std::string pattern;
+    while (std::getline(ss, pattern, ',')) {
+        if (pattern.empty()) {
+            continue;
+        }
+        if (fnmatch(pattern.c_str(), name, FNM_CASEFOLD) == 0 ||
+            fnmatch(pattern.c_str(), display_name, FNM_CASEFOLD) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// An empty filter runs the default set (plus the extended set with -a); an
+// implementation named by the filter always runs
+template <typename Entry>
+bool impl_selected(const Entry& entry, const std::string& filter, bool run_all_impls) {
+    if (filter.empty()) {
+        return !entry.extended || run_all_impls;
+    }
+    return impl_matches(filter, entry.name, entry.display_name);
+}
+
+} // namespace hashmap_bench
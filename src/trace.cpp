@@ -0,0 +1,188 @@
+#include "trace.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+
+#include "key_corpus.hpp"
+
+namespace hashmap_bench {
+
+namespace {
+
+void append_varint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+// False when the value runs past end or past 64 bits
+bool read_varint(const char*& pos, const char* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < end; shift += 7) {
+        uint8_t byte = static_cast<uint8_t>(*pos++);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+struct RawOp {
+    TraceOp op;
+    uint32_t key_id;  // first-appearance order
+};
+
+} // namespace
+
+bool load_trace(const std::string& path, Trace& trace, std::string& error) {
+    MappedFile file;
+    if (!file.open(path, error)) {
+        return false;
+    }
+    const char* pos = file.data();
+    const char* end = pos + file.size();
+    if (file.size() <= kTraceMagicSize || memcmp(pos, kTraceMagic, kTraceMagicSize) != 0) {
+        error = path + ": no HMBTRACE header";
+        return false;
+    }
+    uint8_t kind = static_cast<uint8_t>(pos[kTraceMagicSize]);
+    if (kind > 1) {
+        error = path + ": unknown key kind " + std::to_string(kind);
+        return false;
+    }
+    pos += kTraceMagicSize + 1;
+    trace = Trace{};
+    trace.int_keyed = kind == 1;
+
+    // Decode every record, numbering keys by first appearance. String keys
+    // stay views into the mapping until the distinct ones are copied out.
+    std::vector<RawOp> raw;
+    std::vector<TraceOp> first_op;
+    std::unordered_map<std::string_view, uint32_t> string_ids;
+    std::unordered_map<uint64_t, uint32_t> int_ids;
+    std::vector<std::string_view> id_keys;
+    std::vector<uint64_t> id_ints;
+    while (pos < end) {
+        size_t offset = static_cast<size_t>(pos - file.data());
+        uint8_t op = static_cast<uint8_t>(*pos++);
+        uint64_t value;
+        if (op > static_cast<uint8_t>(TraceOp::Del) || !read_varint(pos, end, value) ||
+            (!trace.int_keyed && static_cast<uint64_t>(end - pos) < value)) {
+            error = path + ": bad record at offset " + std::to_string(offset);
+            return false;
+        }
+        if (first_op.size() == std::numeric_limits<uint32_t>::max()) {
+            error = path + ": more than 2^32 - 1 distinct keys";
+            return false;
+        }
+        // dense/sparse_hash_map cannot hold their empty and deleted markers
+        if (trace.int_keyed ? is_reserved_key(value) : is_reserved_key(std::string_view(pos, value))) {
+            error = path + ": key at offset " + std::to_string(offset) +
+                    " is an empty or deleted marker of dense/sparse_hash_map";
+            return false;
+        }
+        uint32_t next_id = static_cast<uint32_t>(first_op.size());
+        uint32_t id;
+        if (trace.int_keyed) {
+            auto [it, fresh] = int_ids.try_emplace(value, next_id);
+            if (fresh) {
+                id_ints.push_back(value);
+            }
+            id = it->second;
+        } else {
+            std::string_view key(pos, static_cast<size_t>(value));
+            pos += value;
+            auto [it, fresh] = string_ids.try_emplace(key, next_id);
+            if (fresh) {
+                id_keys.push_back(key);
+            }
+            id = it->second;
+        }
+        if (id == next_id) {
+            first_op.push_back(static_cast<TraceOp>(op));
+        }
+        raw.push_back({static_cast<TraceOp>(op), id});
+    }
+    if (raw.empty()) {
+        error = path + ": no operations";
+        return false;
+    }
+
+    // Keys first seen by a get or del take the preloaded indices
+    size_t num_keys = first_op.size();
+    std::vector<uint32_t> index(num_keys);
+    uint32_t preload = 0;
+    for (size_t id = 0; id < num_keys; id++) {
+        if (first_op[id] != TraceOp::Put) {
+            index[id] = preload++;
+        }
+    }
+    uint32_t next = preload;
+    for (size_t id = 0; id < num_keys; id++) {
+        if (first_op[id] == TraceOp::Put) {
+            index[id] = next++;
+        }
+    }
+    if (trace.int_keyed) {
+        trace.int_keys.resize(num_keys);
+        for (size_t id = 0; id < num_keys; id++) {
+            trace.int_keys[index[id]] = id_ints[id];
+        }
+    } else {
+        trace.keys.resize(num_keys);
+        for (size_t id = 0; id < num_keys; id++) {
+            trace.keys[index[id]] = std::string(id_keys[id]);
+        }
+    }
+
+    // Classify each op against the contents of the replayed map
+    Workload& workload = trace.workload;
+    workload.name = "trace:" + path.substr(path.find_last_of('/') + 1);
+    workload.preload = preload;
+    workload.ops.reserve(raw.size());
+    std::vector<uint8_t> live(num_keys, 0);
+    std::fill(live.begin(), live.begin() + preload, 1);
+    for (const RawOp& op : raw) {
+        uint32_t key = index[op.key_id];
+        OpType type = OpType::LookupMiss;
+        switch (op.op) {
+            case TraceOp::Get:
+                type = live[key] ? OpType::LookupHit : OpType::LookupMiss;
+                break;
+            case TraceOp::Put:
+                type = live[key] ? OpType::Update : OpType::Insert;
+                live[key] = 1;
+                break;
+            case TraceOp::Del:
+                type = live[key] ? OpType::Erase : OpType::LookupMiss;
+                live[key] = 0;
+                break;
+        }
+        workload.ops.push_back({type, key});
+        workload.op_counts[static_cast<size_t>(type)]++;
+    }
+    return true;
+}
+
+void append_trace_header(std::string& out, bool int_keyed) {
+    out.append(kTraceMagic, kTraceMagicSize);
+    out += static_cast<char>(int_keyed ? 1 : 0);
+}
+
+void append_trace_op(std::string& out, TraceOp op, std::string_view key) {
+    out += static_cast<char>(op);
+    append_varint(out, key.size());
+    out.append(key.data(), key.size());
+}
+
+void append_trace_op(std::string& out, TraceOp op, uint64_t key) {
+    out += static_cast<char>(op);
+    append_varint(out, key);
+}
+
+} // namespace hashmap_bench
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "benchmark.hpp"
+
+namespace hashmap_bench {
+
+// Recorded operation traces (--trace). A trace file is
+//   "HMBTRACE"  8-byte magic
+//   uint8       key kind: 0 byte-string keys, 1 uint64 keys
+//   records     uint8 op (TraceOp), then the key: a LEB128 length and that
+//               many bytes, or the integer itself in LEB128
+// The file is mapped and decoded once, before anything is timed, into a
+// Workload over the distinct keys. Keys whose first op is a get or del were
+// live when the trace was recorded and are preloaded. Each op is then
+// classified against what the replayed map holds at that point: get is a
+// read or a miss, put an insert or an update, del an erase, or a miss when
+// the key is absent.
+
+enum class TraceOp : uint8_t {
+    Get = 0,
+    Put = 1,
+    Del = 2,
+};
+
+inline constexpr char kTraceMagic[] = "HMBTRACE";
+inline constexpr size_t kTraceMagicSize = 8;
+
+struct Trace {
+    bool int_keyed = false;
+    // Distinct keys, preloaded ones first; only the one matching int_keyed is filled
+    std::vector<std::string> keys;
+    std::vector<uint64_t> int_keys;
+    Workload workload;
+};
+
+// False with a message in error for an unreadable or malformed file
+bool load_trace(const std::string& path, Trace& trace, std::string& error);
+
+// Encoders, for recording tools and the tests
+void append_trace_header(std::string& out, bool int_keyed);
+void append_trace_op(std::string& out, TraceOp op, std::string_view key);
+void append_trace_op(std::string& out, TraceOp op, uint64_t key);
+
+} // namespace hashmap_bench
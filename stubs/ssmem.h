@@ -41,7 +41,9 @@
 /* parameters */
 /* **************************************************************************************** */
 
+#ifndef SSMEM_TRANSPARENT_HUGE_PAGES /* set by -DHASHMAP_BENCH_SSMEM_HUGEPAGES=ON */
 #define SSMEM_TRANSPARENT_HUGE_PAGES 0 /* Use or not Linux transparent huge pages */
+#endif
 #define SSMEM_ZERO_MEMORY            0 /* Initialize allocated memory to 0 or not */
 #define SSMEM_GC_FREE_SET_SIZE 507 /* mem objects to free before doing a GC pass */
 #define SSMEM_GC_RLSE_SET_SIZE 3   /* num of released object before doing a GC pass */
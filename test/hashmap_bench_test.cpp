@@ -5,15 +5,61 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/benchmark/catch_benchmark.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <numeric>
+#include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
+
+#include <stdlib.h>
+#include <unistd.h>
 
 #include "benchmark.hpp"
+#include "compare.hpp"
 #include "hash_maps.hpp"
+#include "hugepages.hpp"
+#include "key_corpus.hpp"
+#include "memory_tracker.hpp"
+#include "numa.hpp"
+#include "registry.hpp"
+#include "trace.hpp"
 
 using namespace hashmap_bench;
 
+// A uniquely named empty file from mkstemp, removed again at scope exit, so
+// concurrent test runs never share a path
+class TempFile {
+public:
+    explicit TempFile(const char* name) {
+        const char* dir = getenv("TMPDIR");
+        path_ = std::string(dir != nullptr && *dir != '\0' ? dir : "/tmp") + "/" + name + "_XXXXXX";
+        int fd = mkstemp(path_.data());
+        REQUIRE(fd >= 0);
+        close(fd);
+    }
+    ~TempFile() { std::remove(path_.c_str()); }
+    TempFile(const TempFile&) = delete;
+    TempFile& operator=(const TempFile&) = delete;
+    
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+};
+
+// Counts allocations for its lifetime, closing the pass even when a
+// REQUIRE throws
+struct MemoryPass {
+    MemoryPass() { memory_tracking_start(); }
+    ~MemoryPass() { memory_tracking_stop(); }
+};
+
 // ============================================================================
 // Key Generation Tests
 // ============================================================================
@@ -49,6 +95,198 @@ TEST_CASE("Key generation - long_string", "[keys]") {
     REQUIRE(keys[0].size() == 256);
 }
 
+TEST_CASE("Key generation - parallel fill matches the sequential generator", "[keys]") {
+    // The original push_back generator: an outer block every 4096 keys sets
+    // characters 2..5, the inner loops count characters 1 and 0
+    auto sequential = [](int num_power, size_t groups) {
+        std::vector<std::string> keys;
+        std::string uuid(groups == 1 ? 6 : groups * 8, '-');
+        uint64_t counter = 0;
+        for (int i = 0; i < (1 << (num_power - 12)); i++) {
+            for (int j = 2, val = counter >> 12; j < 6; j++, val >>= 6) {
+                for (size_t g = 0; g < groups; g++) {
+                    uuid[j + g * 8] = 0x21 + (val & 0x3F);
+                }
+            }
+            for (int j = 0; j < 64; j++) {
+                for (int k = 0; k < 64; k++) {
+                    for (size_t g = 0; g < groups; g++) {
+                        uuid[g * 8 + 1] = 0x21 + j;
+                        uuid[g * 8] = 0x21 + k;
+                    }
+                    counter++;
+                    keys.push_back(uuid);
+                }
+            }
+        }
+        return keys;
+    };
+    
+    std::vector<std::string> keys;
+    generate_short_keys(keys, 18);
+    REQUIRE(keys == sequential(18, 1));
+    generate_mid_keys(keys, 16);
+    REQUIRE(keys == sequential(16, 4));
+    generate_long_keys(keys, 14);
+    REQUIRE(keys == sequential(14, 32));
+    
+    // Below one 4096-key block the set is a prefix of the larger one
+    generate_mid_keys(keys, 4);
+    REQUIRE(keys.size() == 16);
+    REQUIRE(std::equal(keys.begin(), keys.end(), sequential(12, 4).begin()));
+}
+
+TEST_CASE("Key generation - parametric strings", "[keys]") {
+    KeySpec spec;
+    REQUIRE(parse_key_spec("str:24", spec));
+    REQUIRE((spec.min_len == 24 && spec.max_len == 24));
+    REQUIRE(parse_key_spec("str:12-80", spec));
+    REQUIRE((spec.min_len == 12 && spec.max_len == 80));
+    REQUIRE_FALSE(parse_key_spec("str:80-12", spec));
+    REQUIRE_FALSE(parse_key_spec("str:", spec));
+    REQUIRE_FALSE(parse_key_spec("short_string", spec));
+    
+    REQUIRE(parse_key_alphabet("hex", spec.alphabet));
+    REQUIRE(spec.alphabet.size() == 16);
+    REQUIRE(parse_key_alphabet("abca", spec.alphabet));
+    REQUIRE(spec.alphabet == "abc");
+    REQUIRE_FALSE(parse_key_alphabet("aaa", spec.alphabet));
+    
+    // 3^10 < 2^16 <= 3^11
+    spec.prefix_len = 5;
+    REQUIRE(min_key_length(spec, 1ULL << 16) == 16);
+    
+    spec.alphabet = "ab";
+    spec.min_len = spec.max_len = 23;  // 5 prefix + 2 filler + 16 suffix
+    std::vector<std::string> keys;
+    generate_string_keys(keys, 16, spec, 1);
+    std::unordered_set<std::string> unique(keys.begin(), keys.end());
+    REQUIRE(unique.size() == keys.size());
+    bool shaped = std::all_of(keys.begin(), keys.end(), [](const std::string& key) {
+        return key.size() == 23 && key.compare(0, 5, "ababa") == 0 &&
+               key.find_first_not_of("ab") == std::string::npos;
+    });
+    REQUIRE(shaped);
+    
+    spec.alphabet = kAlnumAlphabet;
+    spec.prefix_len = 0;
+    spec.min_len = 12;
+    spec.max_len = 80;
+    generate_string_keys(keys, 14, spec, 7);
+    auto [shortest, longest] = std::minmax_element(keys.begin(), keys.end(),
+        [](const std::string& a, const std::string& b) { return a.size() < b.size(); });
+    REQUIRE(shortest->size() == 12);
+    REQUIRE(longest->size() == 80);
+    REQUIRE(std::unordered_set<std::string>(keys.begin(), keys.end()).size() == keys.size());
+    
+    std::vector<std::string> again;
+    generate_string_keys(again, 14, spec, 7);
+    REQUIRE(again == keys);
+}
+
+TEST_CASE("Key store packs keys contiguously", "[keys]") {
+    std::vector<std::string> keys;
+    generate_mid_keys(keys, 12);
+    keys.push_back("");
+    KeyStore store(keys);
+    REQUIRE(store.size() == keys.size());
+    
+    size_t total = 0;
+    size_t mismatches = 0;
+    for (size_t i = 0; i < keys.size(); i++) {
+        mismatches += store[i] != keys[i];
+        total += keys[i].size();
+    }
+    REQUIRE(mismatches == 0);
+    REQUIRE(store.bytes() == total);
+    REQUIRE(store[1].data() == store[0].data() + keys[0].size());
+    REQUIRE(store[keys.size() - 1].empty());
+    
+    store.clear();
+    REQUIRE(store.empty());
+}
+
+TEST_CASE("Key corpus files", "[keys][corpus]") {
+    TempFile file("hashmap_bench_corpus_test");
+    const std::string& path = file.path();
+    auto write = [&path](const std::string& bytes) {
+        std::ofstream out(path, std::ios::binary);
+        out << bytes;
+    };
+    KeyCorpus corpus;
+    std::string error;
+    
+    write("user:1\nuser:22\r\n\nuser:333");
+    REQUIRE(corpus.open(path, error));
+    REQUIRE(corpus.format() == KeyFileFormat::Lines);
+    REQUIRE(corpus.size() == 3);
+    REQUIRE(corpus.key(1) == "user:22");
+    REQUIRE(corpus.key(2) == "user:333");
+    std::vector<std::string> keys;
+    corpus.copy_keys(keys, 2);
+    REQUIRE(keys == std::vector<std::string>{"user:1", "user:22"});
+    KeyStore store;
+    store.assign(corpus.keys(), 2);
+    REQUIRE(store.size() == 2);
+    REQUIRE(store[1] == "user:22");
+    REQUIRE(corpus.count_duplicates(3) == 0);
+    
+    write("a\nb\na\nc\na");
+    REQUIRE(corpus.open(path, error));
+    REQUIRE(corpus.count_duplicates(2) == 0);
+    REQUIRE(corpus.count_duplicates(5) == 2);
+    
+    // The dense/sparse_hash_map markers are refused
+    write("a\n\xff\nb");
+    REQUIRE_FALSE(corpus.open(path, error));
+    REQUIRE(error.find("key 1") != std::string::npos);
+    
+    std::string records = kKeyFileMagic;
+    for (std::string key : {std::string("a\nb"), std::string("b"), std::string(300, 'x')}) {
+        uint32_t len = static_cast<uint32_t>(key.size());
+        records.append(reinterpret_cast<const char*>(&len), sizeof(len));
+        records += key;
+    }
+    write(records);
+    REQUIRE(corpus.open(path, error));
+    REQUIRE(corpus.format() == KeyFileFormat::Binary);
+    REQUIRE(corpus.size() == 3);
+    REQUIRE(corpus.key(0) == "a\nb");
+    REQUIRE(corpus.key(2).size() == 300);
+    write(records.substr(0, records.size() - 1));
+    REQUIRE_FALSE(corpus.open(path, error));
+    uint32_t empty = 0;
+    write(records + std::string(reinterpret_cast<const char*>(&empty), sizeof(empty)));
+    REQUIRE_FALSE(corpus.open(path, error));
+    
+    std::string ints = kIntFileMagic;
+    for (uint64_t key : {uint64_t{7}, uint64_t{1} << 40, ~uint64_t{0} - 2}) {
+        ints.append(reinterpret_cast<const char*>(&key), sizeof(key));
+    }
+    write(ints);
+    REQUIRE(corpus.open(path, error));
+    REQUIRE(corpus.is_int());
+    REQUIRE(corpus.size() == 3);
+    REQUIRE(corpus.int_key(1) == uint64_t{1} << 40);
+    write(ints + "x");
+    REQUIRE_FALSE(corpus.open(path, error));
+    for (uint64_t reserved : {~uint64_t{0}, ~uint64_t{0} - 1}) {
+        write(ints + std::string(reinterpret_cast<const char*>(&reserved), sizeof(reserved)));
+        REQUIRE_FALSE(corpus.open(path, error));
+        REQUIRE(error.find("key 3 ") != std::string::npos);
+    }
+    uint64_t repeated = 7;
+    write(ints + std::string(reinterpret_cast<const char*>(&repeated), sizeof(repeated)));
+    REQUIRE(corpus.open(path, error));
+    REQUIRE(corpus.count_duplicates(4) == 1);
+    
+    write("\n\n");
+    REQUIRE_FALSE(corpus.open(path, error));
+    REQUIRE(error.find("no keys") != std::string::npos);
+    std::remove(path.c_str());
+    REQUIRE_FALSE(corpus.open(path, error));
+}
+
 TEST_CASE("Key generation - int", "[keys]") {
     std::vector<uint64_t> keys;
     generate_int_keys(keys, 16);
@@ -58,6 +296,72 @@ TEST_CASE("Key generation - int", "[keys]") {
     REQUIRE(keys[65535] == 65535);
 }
 
+TEST_CASE("Access distributions", "[keys]") {
+    AccessDistribution dist;
+
+    SECTION("parsing") {
+        REQUIRE(parse_access_distribution("seq", dist));
+        REQUIRE(dist.pattern == AccessPattern::Sequential);
+        REQUIRE(parse_access_distribution("zipf:0.8", dist));
+        REQUIRE(dist.pattern == AccessPattern::Zipfian);
+        REQUIRE(dist.theta == 0.8);
+        REQUIRE(parse_access_distribution("hotset:90:10", dist));
+        REQUIRE(dist.hot_op_fraction == 0.9);
+        REQUIRE(dist.hot_key_fraction == 0.1);
+        REQUIRE_FALSE(parse_access_distribution("zipf:1.5", dist));
+        REQUIRE_FALSE(parse_access_distribution("hotset:90", dist));
+        REQUIRE_FALSE(parse_access_distribution("gaussian", dist));
+    }
+
+    SECTION("sequential leaves the order empty") {
+        std::vector<uint32_t> indices{1, 2, 3};
+        generate_access_indices(indices, 1000, 1000, dist, 1);
+        REQUIRE(indices.empty());
+    }
+
+    SECTION("zipf concentrates on few keys") {
+        REQUIRE(parse_access_distribution("zipf:0.99", dist));
+        std::vector<uint32_t> indices;
+        generate_access_indices(indices, 10000, 100000, dist, 1);
+        REQUIRE(indices.size() == 100000);
+
+        std::vector<uint32_t> counts(10000, 0);
+        bool in_range = true;
+        for (uint32_t index : indices) {
+            in_range = in_range && index < 10000;
+            counts[index % 10000]++;
+        }
+        REQUIRE(in_range);
+        std::sort(counts.rbegin(), counts.rend());
+        uint64_t top = std::accumulate(counts.begin(), counts.begin() + 100, uint64_t{0});
+        REQUIRE(top > indices.size() / 3);
+    }
+
+    SECTION("hotset routes the configured share of ops") {
+        REQUIRE(parse_access_distribution("hotset:0.9:0.1", dist));
+        std::vector<uint32_t> indices;
+        generate_access_indices(indices, 10000, 100000, dist, 7);
+
+        std::vector<uint32_t> counts(10000, 0);
+        for (uint32_t index : indices) {
+            counts[index]++;
+        }
+        std::sort(counts.rbegin(), counts.rend());
+        uint64_t hot = std::accumulate(counts.begin(), counts.begin() + 1000, uint64_t{0});
+        REQUIRE(hot > 88000);
+        REQUIRE(hot < 92000);
+    }
+
+    SECTION("latest favours recently inserted keys") {
+        REQUIRE(parse_access_distribution("latest", dist));
+        std::vector<uint32_t> indices;
+        generate_access_indices(indices, 10000, 10000, dist, 1);
+        size_t recent = std::count_if(indices.begin(), indices.end(),
+                                      [](uint32_t index) { return index >= 9000; });
+        REQUIRE(recent > indices.size() / 2);
+    }
+}
+
 // ============================================================================
 // Hash Function Tests
 // ============================================================================
@@ -318,10 +622,742 @@ TEST_CASE("boost::flat_map int keys", "[hashmap][boost]") {
     Wrapper::destroy(map);
 }
 
+// ============================================================================
+// Wrapper update/contains/erase Tests
+// ============================================================================
+
+TEST_CASE("Wrapper erase entry points", "[hashmap][erase]") {
+    SECTION("google::dense_hash_map") {
+        using Wrapper = DenseHashMapWrapper<std::string, uint64_t>;
+        auto map = Wrapper::create(100);
+        Wrapper::insert(map, "key1", 100);
+        Wrapper::insert(map, "key2", 200);
+        Wrapper::update(map, "key1", 111);
+        
+        REQUIRE(Wrapper::lookup(map, "key1") == 111);
+        REQUIRE(Wrapper::contains(map, "key2"));
+        Wrapper::erase(map, "key2");
+        REQUIRE_FALSE(Wrapper::contains(map, "key2"));
+        REQUIRE_FALSE(Wrapper::contains(map, "key3"));
+        Wrapper::destroy(map);
+    }
+    
+    SECTION("boost::flat_map") {
+        using Wrapper = BoostFlatMapWrapper<uint64_t, uint64_t>;
+        auto map = Wrapper::create(100);
+        Wrapper::insert(map, 1, 100);
+        Wrapper::update(map, 1, 101);
+        
+        REQUIRE(Wrapper::lookup(map, 1) == 101);
+        Wrapper::erase(map, 1);
+        REQUIRE_FALSE(Wrapper::contains(map, 1));
+        Wrapper::destroy(map);
+    }
+    
+    SECTION("libcuckoo::cuckoohash_map") {
+        using Wrapper = CuckooHashMapWrapper<uint64_t, uint64_t>;
+        auto map = Wrapper::create(100);
+        Wrapper::insert(map, 1, 100);
+        Wrapper::update(map, 1, 101);
+        
+        REQUIRE(Wrapper::lookup(map, 1) == 101);
+        Wrapper::erase(map, 1);
+        REQUIRE_FALSE(Wrapper::contains(map, 1));
+        Wrapper::destroy(map);
+    }
+}
+
+TEST_CASE("Clear and reuse", "[hashmap][clear]") {
+    std::vector<std::string> keys = {"key1", "key2", "key3"};
+    auto clear_and_refill = [&keys](auto wrapper) {
+        using Wrapper = decltype(wrapper);
+        auto map = Wrapper::create(keys.size());
+        for (const auto& key : keys) {
+            Wrapper::insert(map, key, 1);
+        }
+        clear_map<Wrapper>(map, keys);
+        for (const auto& key : keys) {
+            REQUIRE_FALSE(Wrapper::contains(map, key));
+        }
+        Wrapper::insert(map, keys[0], 2);
+        REQUIRE(Wrapper::lookup(map, keys[0]) == 2);
+        Wrapper::destroy(map);
+    };
+    
+    STATIC_REQUIRE(has_clear<StdMapWrapper<std::string, uint64_t>>::value);
+    STATIC_REQUIRE_FALSE(has_clear<RhashmapWrapper>::value);
+    clear_and_refill(StdUnorderedMapWrapper<std::string, uint64_t>{});
+    clear_and_refill(AbslFlatHashMapWrapper<std::string, uint64_t>{});
+    clear_and_refill(StdMapSlabWrapper<std::string, uint64_t>{});
+    clear_and_refill(RhashmapWrapper{});  // erases key by key
+}
+
+TEST_CASE("Teardown timing", "[hashmap][destroy]") {
+    std::vector<std::string> keys;
+    for (int i = 0; i < 4096; i++) {
+        keys.push_back("teardown_" + std::to_string(i));
+    }
+    auto populated_destroy_time = [&keys](auto wrapper) {
+        using Wrapper = decltype(wrapper);
+        using Map = typename Wrapper::Map;
+        std::unique_ptr<Map> holder(new Map(Wrapper::create(keys.size())));
+        for (const auto& key : keys) {
+            Wrapper::insert(*holder, key, 1);
+        }
+        double seconds = destroy_map<Wrapper>(holder);
+        REQUIRE(holder == nullptr);
+        return seconds;
+    };
+    
+    REQUIRE(populated_destroy_time(StdUnorderedMapWrapper<std::string, uint64_t>{}) > 0);
+    REQUIRE(populated_destroy_time(StdUnorderedMapArenaWrapper<std::string, uint64_t, SlabPoolResource>{}) > 0);
+    REQUIRE(populated_destroy_time(RhashmapWrapper{}) > 0);
+}
+
+TEST_CASE("Lookup through std::string_view", "[hashmap][view]") {
+    // Longer than the SSO buffer, so a copied view allocates
+    std::vector<std::string> keys = {"a-key-longer-than-sixteen-bytes", "short", "another-long-key-0123456789"};
+    std::string buffer = "xx" + keys[0] + keys[1] + keys[2];
+    std::vector<std::string_view> views = {
+        std::string_view(buffer).substr(2, keys[0].size()),
+        std::string_view(buffer).substr(2 + keys[0].size(), keys[1].size()),
+        std::string_view(buffer).substr(2 + keys[0].size() + keys[1].size(), keys[2].size()),
+    };
+    auto lookup_views = [&keys, &views](auto wrapper) {
+        using Wrapper = decltype(wrapper);
+        auto map = Wrapper::create(keys.size());
+        for (size_t i = 0; i < keys.size(); i++) {
+            Wrapper::insert(map, keys[i], i + 10);
+        }
+        size_t wrong = 0;
+        for (size_t i = 0; i < views.size(); i++) {
+            wrong += lookup_by_view<Wrapper>(map, views[i]) != i + 10;
+        }
+        Wrapper::destroy(map);
+        return wrong;
+    };
+    
+    STATIC_REQUIRE(has_lookup_view<StdUnorderedMapWrapper<std::string, uint64_t>>::value);
+    STATIC_REQUIRE(has_lookup_view<AbslFlatHashMapWrapper<std::string, uint64_t>>::value);
+    STATIC_REQUIRE(has_lookup_view<RhashmapWrapper>::value);
+    STATIC_REQUIRE_FALSE(has_lookup_view<DenseHashMapWrapper<std::string, uint64_t>>::value);
+    REQUIRE(lookup_views(StdUnorderedMapWrapper<std::string, uint64_t>{}) == 0);
+    REQUIRE(lookup_views(StdMapWrapper<std::string, uint64_t>{}) == 0);
+    REQUIRE(lookup_views(AbslFlatHashMapWrapper<std::string, uint64_t>{}) == 0);
+    REQUIRE(lookup_views(AbslBtreeMapWrapper<std::string, uint64_t>{}) == 0);
+    REQUIRE(lookup_views(RhashmapWrapper{}) == 0);
+    REQUIRE(lookup_views(DenseHashMapWrapper<std::string, uint64_t>{}) == 0);  // copies
+}
+
+TEST_CASE("Growth from an empty map", "[hashmap][growth]") {
+    STATIC_REQUIRE(has_capacity<AbslFlatHashMapWrapper<uint64_t, uint64_t>>::value);
+    STATIC_REQUIRE(has_capacity<ClhtLbWrapper>::value);
+    STATIC_REQUIRE_FALSE(has_capacity<StdMapWrapper<uint64_t, uint64_t>>::value);
+    
+    reserve_capacity = false;
+    REQUIRE(initial_capacity(1000) == 0);
+    reserve_capacity = true;
+    REQUIRE(initial_capacity(1000) == 1000);
+    
+    // Capacity only grows while inserting, in a few large steps
+    auto count_resizes = [](auto wrapper) {
+        using Wrapper = decltype(wrapper);
+        auto map = Wrapper::create(0);
+        size_t capacity = Wrapper::capacity(map);
+        size_t resizes = 0;
+        bool shrank = false;
+        for (uint64_t key = 1; key <= 4096; key++) {
+            Wrapper::insert(map, key, key);
+            size_t grown = Wrapper::capacity(map);
+            shrank = shrank || grown < capacity;
+            resizes += grown != capacity;
+            capacity = grown;
+        }
+        REQUIRE_FALSE(shrank);
+        REQUIRE(Wrapper::lookup(map, 4096) == 4096);
+        Wrapper::destroy(map);
+        return resizes;
+    };
+    size_t absl_resizes = count_resizes(AbslFlatHashMapWrapper<uint64_t, uint64_t>{});
+    REQUIRE(absl_resizes > 3);
+    REQUIRE(absl_resizes < 20);
+    REQUIRE(count_resizes(StdUnorderedMapWrapper<uint64_t, uint64_t>{}) > 3);
+}
+
+TEST_CASE("Load factor sizing", "[hashmap][loadfactor]") {
+    std::vector<double> points;
+    REQUIRE(parse_sweep("0.5:0.95:0.05", 0.0, 1.0, points));
+    REQUIRE(points.size() == 10);
+    REQUIRE(points.back() == 0.95);
+    REQUIRE(parse_sweep("0.75", 0.0, 1.0, points));
+    REQUIRE(points == std::vector<double>{0.75});
+    REQUIRE_FALSE(parse_sweep("0:0.9:0.1", 0.0, 1.0, points));
+    REQUIRE_FALSE(parse_sweep("0.5:1.5:0.1", 0.0, 1.0, points));
+    REQUIRE_FALSE(parse_sweep("0.9:0.5:0.1", 0.0, 1.0, points));
+    REQUIRE_FALSE(parse_sweep("0.5:0.9", 0.0, 1.0, points));
+    
+    std::vector<uint64_t> keys;
+    generate_int_keys(keys, 14);
+    auto occupancy = [&keys](auto wrapper) {
+        using Wrapper = decltype(wrapper);
+        size_t count = sweep_key_count<Wrapper>(keys.size());
+        REQUIRE(count <= keys.size());
+        auto map = Wrapper::create(count);
+        for (size_t i = 0; i < count; i++) {
+            Wrapper::insert(map, keys[i], keys[i]);
+        }
+        double filled = static_cast<double>(count) / Wrapper::capacity(map);
+        Wrapper::destroy(map);
+        return filled;
+    };
+    
+    // Sweep points fill the table to the target despite power-of-two rounding
+    for (double target : {0.5, 0.7, 0.8}) {
+        target_load_factor = target;
+        REQUIRE(sized_for_load(1000, kSwissMaxLoad) == static_cast<size_t>(1000 * kSwissMaxLoad / target));
+        REQUIRE(occupancy(AbslFlatHashMapWrapper<uint64_t, uint64_t>{}) == Approx(target).epsilon(0.03));
+        REQUIRE(occupancy(AbslNodeHashMapWrapper<uint64_t, uint64_t>{}) == Approx(target).epsilon(0.03));
+        REQUIRE(occupancy(StdUnorderedMapWrapper<uint64_t, uint64_t>{}) == Approx(target).epsilon(0.03));
+    }
+    REQUIRE(sweep_key_count<StdMapWrapper<uint64_t, uint64_t>>(keys.size()) == keys.size());
+    target_load_factor = 0;
+    REQUIRE(sized_for_load(1000, kSwissMaxLoad) == 1000);
+}
+
+TEST_CASE("Wrapper find reports misses", "[hashmap][miss]") {
+    std::vector<std::string> keys;
+    generate_short_keys(keys, 12);
+    std::vector<std::string> misses;
+    generate_miss_keys(keys, misses);
+    
+    REQUIRE(misses.size() == keys.size());
+    std::unordered_set<std::string> key_set(keys.begin(), keys.end());
+    size_t overlap = std::count_if(misses.begin(), misses.end(),
+                                   [&key_set](const std::string& k) { return key_set.count(k) > 0; });
+    REQUIRE(overlap == 0);
+    
+    SECTION("google::dense_hash_map lookup does not insert") {
+        using Wrapper = DenseHashMapWrapper<std::string, uint64_t>;
+        auto map = Wrapper::create(keys.size());
+        for (const auto& key : keys) {
+            Wrapper::insert(map, key, 7);
+        }
+        REQUIRE(Wrapper::find(map, keys[0]) == std::optional<uint64_t>(7));
+        REQUIRE(std::none_of(misses.begin(), misses.end(),
+                             [&map](const std::string& k) { return Wrapper::find(map, k).has_value(); }));
+        REQUIRE(map.size() == keys.size());
+        Wrapper::destroy(map);
+    }
+    
+    SECTION("std::unordered_map int keys") {
+        using Wrapper = StdUnorderedMapWrapper<uint64_t, uint64_t>;
+        std::vector<uint64_t> int_keys;
+        std::vector<uint64_t> int_misses;
+        generate_int_keys(int_keys, 12);
+        generate_miss_keys(int_keys, int_misses);
+        REQUIRE(int_misses.front() == int_keys.back() + 1);
+        
+        auto map = Wrapper::create(int_keys.size());
+        for (uint64_t key : int_keys) {
+            Wrapper::insert(map, key, key);
+        }
+        REQUIRE(Wrapper::find(map, 42) == std::optional<uint64_t>(42));
+        REQUIRE_FALSE(Wrapper::find(map, int_misses.back()).has_value());
+        Wrapper::destroy(map);
+    }
+    
+    SECTION("libcuckoo::cuckoohash_map") {
+        using Wrapper = CuckooHashMapWrapper<std::string, uint64_t>;
+        auto map = Wrapper::create(100);
+        Wrapper::insert(map, keys[1], 3);
+        REQUIRE(Wrapper::find(map, keys[1]) == std::optional<uint64_t>(3));
+        REQUIRE_FALSE(Wrapper::find(map, misses[1]).has_value());
+        Wrapper::destroy(map);
+    }
+}
+
+TEST_CASE("Miss keys are probed for absence", "[keys][miss]") {
+    // Non-ASCII keys whose high-bit flips are keys themselves
+    std::vector<std::string> keys = {"a", "\xe1", "b", "\xe2\x80", "\x62\x80"};
+    std::vector<std::string> misses;
+    generate_miss_keys(keys, misses);
+    REQUIRE(misses.size() == keys.size());
+    for (const auto& miss : misses) {
+        REQUIRE(std::find(keys.begin(), keys.end(), miss) == keys.end());
+        REQUIRE_FALSE(is_reserved_key(miss));
+    }
+    REQUIRE(misses[2] == "\xe2");  // the flip of "b" is free
+    
+    // A corpus may hold the largest usable value; misses wrap past the markers
+    std::vector<uint64_t> int_keys = {0, 1, 5, ~uint64_t{0} - 2};
+    std::vector<uint64_t> int_misses;
+    generate_miss_keys(int_keys, int_misses);
+    REQUIRE(int_misses == std::vector<uint64_t>{2, 3, 4, 6});
+}
+
+// ============================================================================
+// Workload Engine Tests
+// ============================================================================
+
+TEST_CASE("Batched lookup and insert", "[hashmap][batch]") {
+    std::vector<std::string> keys;
+    generate_short_keys(keys, 12);
+    std::vector<uint64_t> values(keys.size());
+    std::iota(values.begin(), values.end(), uint64_t{1});
+    
+    // Group sizes below, at and above kBatchWindow, ending in a partial group
+    auto check = [&](auto* wrapper) {
+        using Wrapper = std::remove_pointer_t<decltype(wrapper)>;
+        bool ok = true;
+        for (size_t group : {size_t{1}, size_t{16}, kBatchWindow, size_t{100}}) {
+            auto map = Wrapper::create(keys.size());
+            for (size_t i = 0; i < keys.size(); i += group) {
+                size_t n = std::min(group, keys.size() - i);
+                insert_batch<Wrapper>(map, keys.data() + i, n, values.data() + i);
+            }
+            std::vector<uint64_t> out(keys.size());
+            for (size_t i = 0; i < keys.size(); i += group) {
+                size_t n = std::min(group, keys.size() - i);
+                lookup_batch<Wrapper>(map, keys.data() + i, n, out.data() + i);
+            }
+            ok = ok && out == values && Wrapper::find(map, keys.back()) == values.back();
+            Wrapper::destroy(map);
+        }
+        return ok;
+    };
+    
+    STATIC_REQUIRE(has_batch_lookup<AbslFlatHashMapWrapper<std::string, uint64_t>, std::string, uint64_t>::value);
+    STATIC_REQUIRE(has_batch_insert<FollyF14FastMapWrapper<std::string, uint64_t>, std::string, uint64_t>::value);
+    STATIC_REQUIRE_FALSE(has_batch_lookup<StdUnorderedMapWrapper<std::string, uint64_t>, std::string, uint64_t>::value);
+    
+    REQUIRE(check(static_cast<AbslFlatHashMapWrapper<std::string, uint64_t>*>(nullptr)));
+    REQUIRE(check(static_cast<AbslNodeHashMapWrapper<std::string, uint64_t>*>(nullptr)));
+    REQUIRE(check(static_cast<FollyF14FastMapWrapper<std::string, uint64_t>*>(nullptr)));
+    REQUIRE(check(static_cast<PhmapFlatHashMapWrapper<std::string, uint64_t>*>(nullptr)));
+    REQUIRE(check(static_cast<PhmapParallelHashMapWrapper<std::string, uint64_t>*>(nullptr)));
+    // Scalar fallback
+    REQUIRE(check(static_cast<StdUnorderedMapWrapper<std::string, uint64_t>*>(nullptr)));
+    REQUIRE(check(static_cast<StdMapWrapper<std::string, uint64_t>*>(nullptr)));
+    
+    // The token-hinted F14 insert overwrites a present key, as insert() does
+    using F14 = FollyF14FastMapWrapper<std::string, uint64_t>;
+    auto f14 = F14::create(keys.size());
+    insert_batch<F14>(f14, keys.data(), 4, values.data());
+    insert_batch<F14>(f14, keys.data(), 4, values.data() + 4);
+    REQUIRE(F14::lookup(f14, keys[0]) == values[4]);
+    F14::destroy(f14);
+}
+
+TEST_CASE("Workload parsing", "[workload]") {
+    WorkloadMix mix;
+    
+    REQUIRE(parse_workload("ycsb-a", mix));
+    REQUIRE(mix.ratios[static_cast<size_t>(OpType::LookupHit)] == 50);
+    REQUIRE(mix.ratios[static_cast<size_t>(OpType::Update)] == 50);
+    
+    REQUIRE(parse_workload("f", mix));
+    REQUIRE(mix.ratios[static_cast<size_t>(OpType::ReadModifyWrite)] == 50);
+    
+    REQUIRE(parse_workload("10:0:70:10:10", mix));
+    REQUIRE(mix.ratios[static_cast<size_t>(OpType::Insert)] == 10);
+    REQUIRE(mix.ratios[static_cast<size_t>(OpType::Erase)] == 10);
+    
+    REQUIRE_FALSE(parse_workload("ycsb-e", mix));
+    REQUIRE_FALSE(parse_workload("1:2", mix));
+    REQUIRE_FALSE(parse_workload("0:0:0:0:0", mix));
+    REQUIRE_FALSE(parse_workload("1:x:1:1:1", mix));
+}
+
+TEST_CASE("Workload generation keeps hits and misses consistent", "[workload]") {
+    WorkloadMix mix;
+    REQUIRE(parse_workload("10:10:40:20:15:5", mix));
+    
+    const size_t num_keys = 10000;
+    Workload workload = generate_workload(mix, num_keys, 50000, 42);
+    
+    REQUIRE(workload.preload == num_keys / 2);
+    REQUIRE(workload.ops.size() == 50000);
+    
+    // Replay against a reference set
+    std::unordered_set<uint32_t> live;
+    for (uint32_t i = 0; i < workload.preload; i++) {
+        live.insert(i);
+    }
+    bool consistent = true;
+    for (const Operation& op : workload.ops) {
+        bool present = live.count(op.key_index) > 0;
+        switch (op.type) {
+            case OpType::Insert:
+                consistent = consistent && !present;
+                live.insert(op.key_index);
+                break;
+            case OpType::LookupMiss:
+                consistent = consistent && !present;
+                break;
+            case OpType::Erase:
+                consistent = consistent && present;
+                live.erase(op.key_index);
+                break;
+            default:
+                consistent = consistent && present;
+                break;
+        }
+        consistent = consistent && op.key_index < num_keys;
+    }
+    REQUIRE(consistent);
+    
+    // Same seed, same stream
+    Workload again = generate_workload(mix, num_keys, 50000, 42);
+    REQUIRE(again.ops.size() == workload.ops.size());
+    REQUIRE(std::equal(workload.ops.begin(), workload.ops.end(), again.ops.begin(),
+        [](const Operation& a, const Operation& b) {
+            return a.type == b.type && a.key_index == b.key_index;
+        }));
+}
+
+TEST_CASE("WorkloadBenchmark replays through a wrapper", "[workload]") {
+    using Wrapper = StdUnorderedMapWrapper<uint64_t, uint64_t>;
+    
+    WorkloadMix mix;
+    REQUIRE(parse_workload("ycsb-b", mix));
+    std::vector<uint64_t> keys;
+    generate_int_keys(keys, 14);
+    Workload workload = generate_workload(mix, keys.size(), keys.size(), 7);
+    
+    BenchmarkResult result = WorkloadBenchmark<Wrapper>::run("std::unordered_map", "int64", keys, workload);
+    
+    REQUIRE(result.num_elements == keys.size() / 2);
+    REQUIRE(result.num_ops == keys.size());
+    REQUIRE(result.workload == "ycsb-b");
+    REQUIRE(result.query_time_sec > 0);
+}
+
+TEST_CASE("Trace decoding and replay", "[workload][trace]") {
+    TempFile file("hashmap_bench_trace_test");
+    const std::string& path = file.path();
+    auto write = [&path](const std::string& bytes) {
+        std::ofstream out(path, std::ios::binary);
+        out << bytes;
+    };
+    
+    // "old" predates the trace (first op a get), "new" is put during it
+    std::string bytes;
+    append_trace_header(bytes, false);
+    append_trace_op(bytes, TraceOp::Get, "old");
+    append_trace_op(bytes, TraceOp::Put, "new");
+    append_trace_op(bytes, TraceOp::Put, "new");
+    append_trace_op(bytes, TraceOp::Del, "old");
+    append_trace_op(bytes, TraceOp::Get, "old");
+    append_trace_op(bytes, TraceOp::Del, "old");
+    append_trace_op(bytes, TraceOp::Get, std::string(200, 'k'));
+    write(bytes);
+    
+    Trace trace;
+    std::string error;
+    REQUIRE(load_trace(path, trace, error));
+    REQUIRE_FALSE(trace.int_keyed);
+    REQUIRE(trace.workload.preload == 2);
+    REQUIRE(trace.keys == std::vector<std::string>{"old", std::string(200, 'k'), "new"});
+    std::vector<OpType> types;
+    for (const Operation& op : trace.workload.ops) {
+        types.push_back(op.type);
+    }
+    REQUIRE(types == std::vector<OpType>{OpType::LookupHit, OpType::Insert, OpType::Update, OpType::Erase,
+                                         OpType::LookupMiss, OpType::LookupMiss, OpType::LookupHit});
+    
+    BenchmarkResult result = WorkloadBenchmark<AbslFlatHashMapWrapper<std::string, uint64_t>>::run(
+        "absl::flat_hash_map", "trace", trace.keys, trace.workload, 1);
+    REQUIRE(result.num_ops == 7);
+    REQUIRE(result.op_results.size() == kNumOpTypes);
+    REQUIRE(result.op_results[static_cast<size_t>(OpType::LookupMiss)].ops == 2);
+    REQUIRE(result.op_results[static_cast<size_t>(OpType::LookupMiss)].latency.samples == 2);
+    REQUIRE(result.op_results[static_cast<size_t>(OpType::ReadModifyWrite)].ops == 0);
+    
+    std::string ints;
+    append_trace_header(ints, true);
+    append_trace_op(ints, TraceOp::Put, uint64_t{1} << 40);
+    append_trace_op(ints, TraceOp::Get, uint64_t{1} << 40);
+    write(ints);
+    REQUIRE(load_trace(path, trace, error));
+    REQUIRE(trace.int_keyed);
+    REQUIRE(trace.int_keys == std::vector<uint64_t>{uint64_t{1} << 40});
+    REQUIRE(trace.workload.preload == 0);
+    
+    // The dense/sparse_hash_map markers are refused
+    for (uint64_t reserved : {~uint64_t{0}, ~uint64_t{0} - 1}) {
+        std::string marked = ints;
+        append_trace_op(marked, TraceOp::Put, reserved);
+        write(marked);
+        REQUIRE_FALSE(load_trace(path, trace, error));
+        REQUIRE(error.find("marker") != std::string::npos);
+    }
+    std::string empty_key = bytes;
+    append_trace_op(empty_key, TraceOp::Get, "");
+    write(empty_key);
+    REQUIRE_FALSE(load_trace(path, trace, error));
+    
+    write(bytes.substr(0, bytes.size() - 1));
+    REQUIRE_FALSE(load_trace(path, trace, error));
+    write("HMBKEYS1");
+    REQUIRE_FALSE(load_trace(path, trace, error));
+}
+
+// ============================================================================
+// Concurrent Wrapper Tests
+// ============================================================================
+
+TEST_CASE("phmap::parallel_flat_hash_map (mutex) concurrent inserts", "[hashmap][phmap][concurrent]") {
+    using Wrapper = PhmapParallelHashMapMtWrapper<uint64_t, uint64_t>;
+    using Map = typename Wrapper::Map;
+    
+    Map map = Wrapper::create(4000);
+    
+    std::vector<std::thread> workers;
+    for (uint64_t t = 0; t < 4; t++) {
+        workers.emplace_back([&map, t] {
+            for (uint64_t k = t * 1000; k < (t + 1) * 1000; k++) {
+                Wrapper::insert(map, k, k + 1);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    
+    REQUIRE(map.size() == 4000);
+    REQUIRE(Wrapper::lookup(map, 0) == 1);
+    REQUIRE(Wrapper::lookup(map, 3999) == 4000);
+    
+    Wrapper::destroy(map);
+}
+
+TEST_CASE("Thread placement helpers", "[threads]") {
+    std::vector<int> cpus = available_cpus();
+    
+    REQUIRE(!cpus.empty());
+    // Pin a scratch thread, so the later tests keep every CPU
+    bool pinned = false;
+    std::vector<int> pinned_cpus;
+    std::thread([&] {
+        pinned = pin_current_thread(cpus[0]);
+        pinned_cpus = available_cpus();
+    }).join();
+    REQUIRE(pinned);
+    REQUIRE(pinned_cpus == std::vector<int>{cpus[0]});
+    REQUIRE(available_cpus() == cpus);
+}
+
+// ============================================================================
+// Memory Accounting Tests
+// ============================================================================
+
+TEST_CASE("NUMA placement helpers", "[threads][numa]") {
+    std::vector<int> nodes;
+    REQUIRE(parse_node_list("0", nodes));
+    REQUIRE(nodes == std::vector<int>{0});
+    REQUIRE(parse_node_list("0-0,0", nodes));
+    REQUIRE(nodes == std::vector<int>{0});
+    REQUIRE(parse_node_list("all", nodes));
+    REQUIRE(nodes.size() <= static_cast<size_t>(numa_num_nodes()));
+    REQUIRE(format_node_list({0, 1, 3}) == "0,1,3");
+    REQUIRE_FALSE(parse_node_list("", nodes));
+    REQUIRE_FALSE(parse_node_list("x", nodes));
+    REQUIRE_FALSE(parse_node_list("1-0", nodes));
+    REQUIRE_FALSE(parse_node_list(std::to_string(numa_num_nodes()), nodes));
+    
+    // Node 0 always exists and holds some of our CPUs on a non-NUMA machine
+    std::vector<int> home = available_cpus();
+    std::vector<int> node0 = numa_node_cpus(0);
+    REQUIRE_FALSE(node0.empty());
+    REQUIRE(std::includes(home.begin(), home.end(), node0.begin(), node0.end()));
+    REQUIRE(numa_node_cpus(numa_num_nodes()).empty());
+    
+    REQUIRE(numa_run_on_node(0));
+    REQUIRE(available_cpus() == node0);
+    REQUIRE(numa_run_on_cpus(home));
+    REQUIRE(available_cpus() == home);
+    
+    REQUIRE(numa_set_mempolicy(MemPolicy::Bind, {0}));
+    std::vector<uint64_t> bound(1 << 16, 1);
+    REQUIRE(std::accumulate(bound.begin(), bound.end(), uint64_t{0}) == bound.size());
+    REQUIRE(numa_set_mempolicy(MemPolicy::Default, {}));
+}
+
+TEST_CASE("Counting allocator hook", "[memory]") {
+    SECTION("off outside a memory pass") {
+        { MemoryPass pass; }
+        void* p = malloc(1 << 20);
+        REQUIRE(memory_live_bytes() == 0);
+        free(p);
+        REQUIRE(memory_live_bytes() == 0);
+    }
+    
+    SECTION("malloc family") {
+        MemoryPass pass;
+        void* p = malloc(1 << 20);
+        REQUIRE(memory_live_bytes() >= (1 << 20));
+        p = realloc(p, 2 << 20);
+        REQUIRE(memory_live_bytes() >= (2 << 20));
+        free(p);
+        REQUIRE(memory_live_bytes() < (1 << 20));
+        REQUIRE(memory_peak_bytes() >= (2 << 20));
+    }
+    
+    SECTION("operator new and containers") {
+        MemoryPass pass;
+        {
+            std::vector<uint64_t> v(1 << 16);
+            REQUIRE(memory_live_bytes() >= (1 << 16) * sizeof(uint64_t));
+        }
+        
+        using Wrapper = StdUnorderedMapWrapper<uint64_t, uint64_t>;
+        Wrapper::Map map = Wrapper::create(1000);
+        for (uint64_t k = 0; k < 1000; k++) {
+            Wrapper::insert(map, k, k);
+        }
+        REQUIRE(memory_live_bytes() >= 1000 * 2 * sizeof(uint64_t));
+        Wrapper::destroy(map);
+    }
+    
+    SECTION("untimed memory pass") {
+        std::vector<uint64_t> keys;
+        generate_int_keys(keys, 10);
+        BenchmarkResult result;
+        measure_memory<StdUnorderedMapWrapper<uint64_t, uint64_t>>(keys, keys.size(), result);
+        REQUIRE(result.memory_bytes >= keys.size() * 2 * sizeof(uint64_t));
+        REQUIRE(result.peak_memory_bytes >= result.memory_bytes);
+        
+        void* p = malloc(1 << 20);
+        REQUIRE(memory_live_bytes() == result.memory_bytes);
+        free(p);
+    }
+}
+
 // ============================================================================
 // Timer Tests
 // ============================================================================
 
+TEST_CASE("Huge page allocator", "[memory][hugepages]") {
+    HugePageMode mode;
+    REQUIRE(parse_hugepage_mode("thp", mode));
+    REQUIRE(mode == HugePageMode::Thp);
+    REQUIRE(parse_hugepage_mode("hugetlb", mode));
+    REQUIRE(std::string(hugepage_mode_name(mode)) == "hugetlb");
+    REQUIRE_FALSE(parse_hugepage_mode("on", mode));
+    
+    HugePageAllocator<uint64_t> alloc;
+    size_t large = kHugePageSize / sizeof(uint64_t) + 1;
+    for (HugePageMode m : {HugePageMode::Off, HugePageMode::Thp, HugePageMode::Hugetlb}) {
+        set_hugepage_mode(m);
+        HugePageStats before = hugepage_stats();
+        MemoryPass pass;
+        size_t base = memory_live_bytes();
+        
+        uint64_t* small = alloc.allocate(16);
+        uint64_t* big = alloc.allocate(large);
+        big[0] = 1;
+        big[large - 1] = 2;
+        REQUIRE(memory_live_bytes() - base >= large * sizeof(uint64_t));
+        if (m != HugePageMode::Off) {
+            REQUIRE(reinterpret_cast<uintptr_t>(big) % kHugePageSize == 0);
+        }
+        HugePageStats after = hugepage_stats();
+        size_t blocks = after.thp_blocks + after.hugetlb_blocks - before.thp_blocks - before.hugetlb_blocks;
+        REQUIRE(blocks == (m == HugePageMode::Off ? 0u : 1u));
+        
+        alloc.deallocate(big, large);
+        alloc.deallocate(small, 16);
+        REQUIRE(memory_live_bytes() == base);
+    }
+    
+    // A container whose bucket array crosses the threshold
+    set_hugepage_mode(HugePageMode::Thp);
+    {
+        using Wrapper = StdUnorderedMapWrapper<uint64_t, uint64_t>;
+        std::vector<uint64_t> keys;
+        generate_int_keys(keys, 18);
+        size_t thp_before = hugepage_stats().thp_blocks;
+        auto map = Wrapper::create(keys.size());
+        for (uint64_t key : keys) {
+            Wrapper::insert(map, key, key);
+        }
+        REQUIRE(hugepage_stats().thp_blocks > thp_before);
+        REQUIRE(Wrapper::lookup(map, keys.back()) == keys.back());
+        Wrapper::destroy(map);
+    }
+    set_hugepage_mode(HugePageMode::Off);
+}
+
+TEST_CASE("Slab pool and arena-backed maps", "[memory][arena]") {
+    SlabPoolResource pool;
+    void* a = pool.allocate(40, 8);
+    void* b = pool.allocate(40, 8);
+    REQUIRE(pool.slab_count() == 1);
+    REQUIRE(static_cast<char*>(b) - static_cast<char*>(a) == 48);
+    pool.deallocate(a, 40, 8);
+    REQUIRE(pool.allocate(33, 8) == a);  // same 48-byte class, reused
+    pool.allocate(100, 8);
+    REQUIRE(pool.slab_count() == 2);     // one slab per size class
+    
+    // Oversized and over-aligned requests bypass the slabs
+    void* big = pool.allocate(4096, 8);
+    void* aligned = pool.allocate(32, 64);
+    REQUIRE(reinterpret_cast<uintptr_t>(aligned) % 64 == 0);
+    REQUIRE(pool.slab_count() == 2);
+    pool.deallocate(big, 4096, 8);
+    pool.deallocate(aligned, 32, 64);
+    pool.release();
+    REQUIRE(pool.slab_count() == 0);
+    
+    std::vector<uint64_t> keys;
+    generate_int_keys(keys, 12);
+    auto round_trip = [&keys](auto wrapper) {
+        using Wrapper = decltype(wrapper);
+        MemoryPass pass;
+        size_t base = memory_live_bytes();
+        {
+            auto map = Wrapper::create(keys.size());
+            for (size_t i = 0; i < keys.size(); i++) {
+                Wrapper::insert(map, keys[i], uint64_t(i));
+            }
+            for (size_t i = 0; i < keys.size(); i += 2) {
+                Wrapper::erase(map, keys[i]);
+            }
+            size_t wrong = 0;
+            for (size_t i = 0; i < keys.size(); i++) {
+                wrong += Wrapper::contains(map, keys[i]) != (i % 2 == 1);
+            }
+            REQUIRE(wrong == 0);
+            Wrapper::update(map, keys[1], 7);
+            REQUIRE(Wrapper::lookup(map, keys[1]) == 7);
+            Wrapper::destroy(map);
+        }
+        REQUIRE(memory_live_bytes() == base);
+    };
+    round_trip(StdUnorderedMapMonotonicWrapper<uint64_t, uint64_t>{});
+    round_trip(StdUnorderedMapSlabWrapper<uint64_t, uint64_t>{});
+    round_trip(AbslNodeHashMapMonotonicWrapper<uint64_t, uint64_t>{});
+    round_trip(AbslNodeHashMapSlabWrapper<uint64_t, uint64_t>{});
+    round_trip(StdMapMonotonicWrapper<uint64_t, uint64_t>{});
+    round_trip(StdMapSlabWrapper<uint64_t, uint64_t>{});
+    
+    // Erased nodes are reused, so churn does not grow the pool
+    using Wrapper = StdMapSlabWrapper<uint64_t, uint64_t>;
+    auto map = Wrapper::create(keys.size());
+    for (uint64_t key : keys) {
+        Wrapper::insert(map, key, key);
+    }
+    size_t slabs = map.arena->slab_count();
+    for (uint64_t key : keys) {
+        Wrapper::erase(map, key);
+        Wrapper::insert(map, key + 1, key);
+        Wrapper::erase(map, key + 1);
+        Wrapper::insert(map, key, key);
+    }
+    REQUIRE(map.arena->slab_count() == slabs);
+    REQUIRE(Wrapper::lookup(map, keys.back()) == keys.back());
+}
+
 TEST_CASE("Timer functionality", "[timer]") {
     Timer timer;
     
@@ -337,6 +1373,153 @@ TEST_CASE("Timer functionality", "[timer]") {
     REQUIRE(t2 >= 0.01);  // At least 10ms
 }
 
+TEST_CASE("Clock backends", "[timer]") {
+    SECTION("steady_clock") {
+        Clock::init(ClockSource::SteadyClock);
+        REQUIRE(Clock::source() == ClockSource::SteadyClock);
+        REQUIRE(Clock::ns_per_tick() == 1.0);
+        
+        uint64_t t1 = Clock::now();
+        usleep(1000);
+        REQUIRE(Clock::now() - t1 >= 1000000);
+    }
+    
+    SECTION("TSC calibration") {
+        Clock::init(ClockSource::Tsc);
+        if (Clock::has_invariant_tsc()) {
+            REQUIRE(Clock::source() == ClockSource::Tsc);
+            REQUIRE(Clock::ns_per_tick() > 0.0);
+            REQUIRE(Clock::ns_per_tick() < 10.0);  // faster than 100 MHz
+            
+            Timer timer;
+            usleep(10000);
+            double elapsed = timer.elapsed();
+            REQUIRE(elapsed >= 0.01);
+            REQUIRE(elapsed < 1.0);
+        } else {
+            REQUIRE(Clock::source() == ClockSource::SteadyClock);
+        }
+    }
+    
+    REQUIRE(Clock::overhead_ns() < 1000.0);
+    Clock::init(ClockSource::SteadyClock);
+}
+
+// ============================================================================
+// Latency Histogram Tests
+// ============================================================================
+
+TEST_CASE("LatencyHistogram percentiles", "[latency]") {
+    LatencyHistogram hist;
+    
+    SECTION("small values are exact") {
+        for (uint64_t v = 1; v <= 50; v++) {
+            hist.record(v);
+        }
+        REQUIRE(hist.count() == 50);
+        REQUIRE(hist.percentile(50.0) == 25);
+        REQUIRE(hist.percentile(100.0) == 50);
+        REQUIRE(hist.max() == 50);
+    }
+    
+    SECTION("large values stay within bucket resolution") {
+        for (int i = 0; i < 990; i++) {
+            hist.record(100);
+        }
+        for (int i = 0; i < 10; i++) {
+            hist.record(1000000);
+        }
+        REQUIRE(hist.percentile(50.0) >= 100);
+        REQUIRE(hist.percentile(50.0) <= 104);
+        REQUIRE(hist.percentile(99.9) >= 1000000);
+        REQUIRE(hist.percentile(99.9) <= 1000000 * 103 / 100);
+        REQUIRE(hist.summary().max == 1000000);
+    }
+    
+    SECTION("buckets are contiguous") {
+        bool contiguous = true;
+        for (uint64_t v = 1; v < (1 << 16); v++) {
+            size_t index = LatencyHistogram::bucket_index(v);
+            contiguous = contiguous && index < LatencyHistogram::kNumBuckets
+                && LatencyHistogram::bucket_upper_bound(index) >= v
+                && LatencyHistogram::bucket_index(v - 1) <= index;
+        }
+        REQUIRE(contiguous);
+        REQUIRE(LatencyHistogram::bucket_index(~0ULL) == LatencyHistogram::kNumBuckets - 1);
+    }
+}
+
+TEST_CASE("Hardware performance counters", "[perf]") {
+    PerfCounters counters;
+    counters.start();
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < 100000; i++) {
+        sum += tomas_wang_int64_hash(i);
+    }
+    side_effect += sum;
+    PerfCounts counts = counters.stop();
+    
+    // Counters may be unavailable (containers, perf_event_paranoid); they must
+    // then read as invalid rather than as zero
+    if (!counters.available()) {
+        REQUIRE_FALSE(counts.any());
+    }
+    if (counts.has(PerfEvent::Instructions)) {
+        REQUIRE(counts[PerfEvent::Instructions] > 100000);
+        PerfCounts per_op = counts.per_op(100000);
+        REQUIRE(per_op[PerfEvent::Instructions] > 1.0);
+    }
+    REQUIRE(std::string(perf_event_name(PerfEvent::L1dMisses)) == "L1D-miss");
+}
+
+// ============================================================================
+// Repetition Statistics Tests
+// ============================================================================
+
+TEST_CASE("Repetition statistics", "[stats]") {
+    SECTION("sample statistics") {
+        SampleStats stats = compute_stats({5.0, 1.0, 4.0, 2.0, 3.0});
+        REQUIRE(stats.n == 5);
+        REQUIRE(stats.min == 1.0);
+        REQUIRE(stats.median == 3.0);
+        REQUIRE(stats.mean == 3.0);
+        REQUIRE(std::abs(stats.stddev - std::sqrt(2.5)) < 1e-9);
+        REQUIRE(std::abs(stats.ci95 - 2.776 * std::sqrt(2.5) / std::sqrt(5.0)) < 1e-9);
+        REQUIRE(compute_stats({1.0, 2.0}).median == 1.5);
+        REQUIRE(std::isinf(compute_stats({1.0}).relative_ci()));
+        REQUIRE(student_t_975(1000) == 1.960);
+    }
+    
+    SECTION("aggregation groups by implementation and key type") {
+        BenchmarkResult a;
+        a.impl_name = "map";
+        a.key_type = "int64";
+        a.num_elements = 1000000;
+        a.insert_time_sec = 1.0;
+        a.query_time_sec = 0.5;
+        BenchmarkResult b = a;
+        b.insert_time_sec = 0.5;
+        BenchmarkResult c = a;
+        c.key_type = "short_string";
+        
+        auto aggregates = aggregate_results({a, c, b});
+        REQUIRE(aggregates.size() == 2);
+        REQUIRE(aggregates[0].key_type == "int64");
+        REQUIRE(aggregates[0].insert_mops.n == 2);
+        REQUIRE(aggregates[0].insert_mops.mean == 1.5);
+        REQUIRE(aggregates[0].query_mops.stddev == 0.0);
+        REQUIRE(aggregates[0].miss_mops.n == 0);
+        REQUIRE(aggregates[1].insert_mops.n == 1);
+        
+        // Thread count and access pattern are part of the configuration
+        BenchmarkResult threaded = a;
+        threaded.num_threads = 4;
+        BenchmarkResult skewed = a;
+        skewed.access_pattern = "uniform";
+        REQUIRE(aggregate_results({a, threaded, skewed, b}).size() == 3);
+    }
+}
+
 // ============================================================================
 // Result Printing Tests
 // ============================================================================
@@ -356,3 +1539,207 @@ TEST_CASE("BenchmarkResult printing", "[output]") {
     REQUIRE(result.insert_time_sec == 0.5);
     REQUIRE(result.query_time_sec == 0.3);
 }
+
+TEST_CASE("Result export", "[output]") {
+    BenchmarkResult result;
+    result.impl_name = "test_map";
+    result.key_type = "int64";
+    result.num_elements = 1000;
+    result.insert_time_sec = 0.5;
+    result.query_time_sec = 0.25;
+    result.comments = "quoted \"note\", with comma";
+    result.thread_insert_sec = {0.1, 0.2};
+    RunMetadata metadata = collect_run_metadata();
+    metadata.num_power = 10;
+    metadata.seed = 42;
+    
+    OutputFormat format;
+    REQUIRE(parse_output_format("jsonl", format));
+    REQUIRE(format == OutputFormat::Jsonl);
+    REQUIRE_FALSE(parse_output_format("xml", format));
+    REQUIRE_FALSE(metadata.compiler.empty());
+    
+    SECTION("csv") {
+        std::ostringstream out;
+        write_results(out, OutputFormat::Csv, {result, result}, metadata);
+        std::string csv = out.str();
+        REQUIRE(std::count(csv.begin(), csv.end(), '\n') == 3);
+        REQUIRE(csv.rfind("timestamp,hostname,", 0) == 0);
+        REQUIRE(csv.find(",10,42,1,test_map,int64,1000,") != std::string::npos);
+        REQUIRE(csv.find(",0.1;0.2,") != std::string::npos);
+        REQUIRE(csv.find("\"quoted \"\"note\"\", with comma\"") != std::string::npos);
+    }
+    
+    SECTION("jsonl") {
+        std::ostringstream out;
+        write_results(out, OutputFormat::Jsonl, {result}, metadata);
+        std::string json = out.str();
+        REQUIRE(json.front() == '{');
+        REQUIRE(json.substr(json.size() - 2) == "}\n");
+        REQUIRE(json.find("\"seed\":42") != std::string::npos);
+        REQUIRE(json.find("\"insert_mops\":0.002") != std::string::npos);
+        REQUIRE(json.find("\"thread_insert_sec\":[0.1,0.2]") != std::string::npos);
+        REQUIRE(json.find("\"comments\":\"quoted \\\"note\\\", with comma\"") != std::string::npos);
+    }
+    
+    SECTION("non-finite numbers are null") {
+        BenchmarkResult zero = result;
+        zero.query_time_sec = 0;
+        zero.thread_query_sec = {0.1, std::nan("")};
+        zero.clear_time_sec = std::nan("");  // wrapper without clear()
+        std::ostringstream out;
+        write_results(out, OutputFormat::Jsonl, {zero}, metadata);
+        std::string json = out.str();
+        REQUIRE(json.find("\"query_mops\":null") != std::string::npos);
+        REQUIRE(json.find("\"clear_time_sec\":null") != std::string::npos);
+        REQUIRE(json.find("\"thread_query_sec\":[0.1,null]") != std::string::npos);
+        REQUIRE(json.find(":inf") == std::string::npos);
+        REQUIRE(json.find(",nan") == std::string::npos);
+    }
+}
+
+// ============================================================================
+// Baseline Comparison Tests
+// ============================================================================
+
+TEST_CASE("Baseline comparison", "[compare]") {
+    auto make = [](double insert_sec, size_t memory, int repetition) {
+        BenchmarkResult r;
+        r.impl_name = "test_map";
+        r.key_type = "int64";
+        r.num_elements = 1000000;
+        r.insert_time_sec = insert_sec;
+        r.query_time_sec = 0.5;
+        r.memory_bytes = memory;
+        r.repetition = repetition;
+        r.comments = "KV: int64/uintptr_t";
+        return r;
+    };
+    std::vector<BenchmarkResult> baseline = {make(1.00, 1000, 1), make(1.01, 1000, 2), make(0.99, 1000, 3)};
+    
+    SECTION("jsonl round trip") {
+        TempFile file("hashmap_bench_baseline");
+        const std::string& path = file.path();
+        {
+            std::ofstream out(path);
+            write_results(out, OutputFormat::Jsonl, baseline, collect_run_metadata());
+        }
+        std::vector<BenchmarkResult> loaded;
+        std::string error;
+        REQUIRE(load_results_jsonl(path, loaded, error));
+        REQUIRE(loaded.size() == 3);
+        REQUIRE(loaded[1].impl_name == "test_map");
+        REQUIRE(loaded[1].insert_time_sec == 1.01);
+        REQUIRE(loaded[1].memory_bytes == 1000);
+        REQUIRE(loaded[1].repetition == 2);
+        REQUIRE(loaded[1].comments == "KV: int64/uintptr_t");
+        REQUIRE_FALSE(loaded[1].query_perf.has(PerfEvent::DtlbMisses));
+        
+        REQUIRE_FALSE(load_results_jsonl("/nonexistent/baseline.jsonl", loaded, error));
+    }
+    
+    SECTION("welch t-test") {
+        SampleStats a = compute_stats({10.0, 10.1, 9.9, 10.0});
+        SampleStats b = compute_stats({12.0, 12.1, 11.9, 12.0});
+        REQUIRE(welch_t_test(a, b).significant);
+        REQUIRE(welch_t_test(a, b).t > 0);
+        REQUIRE_FALSE(welch_t_test(a, compute_stats({10.0, 10.2, 9.8, 10.1})).significant);
+        REQUIRE_FALSE(welch_t_test(a, compute_stats({5.0})).testable);
+    }
+    
+    SECTION("regressions beyond the threshold") {
+        std::vector<BenchmarkResult> same = {make(1.00, 1000, 1), make(0.995, 1000, 2), make(1.005, 1000, 3)};
+        std::vector<BenchmarkResult> slower = {make(1.30, 1000, 1), make(1.31, 1000, 2), make(1.29, 1000, 3)};
+        std::vector<BenchmarkResult> bigger = {make(1.00, 2000, 1), make(1.01, 2000, 2), make(0.99, 2000, 3)};
+        auto any_regression = [&](const std::vector<BenchmarkResult>& current, const char* metric) {
+            auto comparisons = compare_results(aggregate_results(baseline), aggregate_results(current), 0.05);
+            return std::any_of(comparisons.begin(), comparisons.end(), [metric](const Comparison& c) {
+                return c.regression && c.metric == metric;
+            });
+        };
+        REQUIRE_FALSE(any_regression(same, "insert_mops"));
+        REQUIRE(any_regression(slower, "insert_mops"));
+        REQUIRE_FALSE(any_regression(slower, "query_mops"));
+        REQUIRE(any_regression(bigger, "memory_bytes"));
+        REQUIRE_FALSE(any_regression(baseline, "memory_bytes"));
+        
+        // A run with another thread count is not the baseline's configuration
+        for (auto& r : slower) {
+            r.num_threads = 4;
+        }
+        REQUIRE_FALSE(any_regression(slower, "insert_mops"));
+    }
+    
+    SECTION("dTLB misses per operation, when both sides have them") {
+        auto with_dtlb = [](std::vector<BenchmarkResult> results, double misses) {
+            for (auto& r : results) {
+                size_t event = static_cast<size_t>(PerfEvent::DtlbMisses);
+                r.query_perf.values[event] = misses + 0.01 * r.repetition;
+                r.query_perf.valid[event] = true;
+            }
+            return results;
+        };
+        auto metrics = [](const std::vector<Comparison>& comparisons) {
+            std::vector<std::string> names;
+            for (const auto& c : comparisons) {
+                names.push_back(c.metric + (c.regression ? "!" : ""));
+            }
+            return names;
+        };
+        auto without = compare_results(aggregate_results(baseline), aggregate_results(with_dtlb(baseline, 2.0)), 0.05);
+        REQUIRE(metrics(without) == std::vector<std::string>{"insert_mops", "query_mops", "memory_bytes"});
+        auto more = compare_results(aggregate_results(with_dtlb(baseline, 1.0)),
+                                    aggregate_results(with_dtlb(baseline, 2.0)), 0.05);
+        REQUIRE(metrics(more).back() == "query_dtlb_miss!");
+    }
+}
+
+// ============================================================================
+// Implementation Registry Tests
+// ============================================================================
+
+TEST_CASE("Implementation registry", "[registry]") {
+    SECTION("names are unique and every entry supports a key type") {
+        std::unordered_set<std::string> names;
+        bool has_wrapper = true;
+        for_each_impl(kImplementations, [&](const auto& entry) {
+            using Entry = std::decay_t<decltype(entry)>;
+            names.insert(entry.name);
+            has_wrapper = has_wrapper && !(std::is_void_v<typename Entry::StringWrapper> &&
+                                           std::is_void_v<typename Entry::IntWrapper>);
+        });
+        REQUIRE(names.size() == std::tuple_size_v<std::decay_t<decltype(kImplementations)>>);
+        REQUIRE(has_wrapper);
+    }
+    
+    SECTION("filter matches names, display names and globs") {
+        REQUIRE(impl_matches("absl_flat_hash_map", "absl_flat_hash_map", "absl::flat_hash_map"));
+        REQUIRE(impl_matches("std_map,absl::btree_map", "absl_btree_map", "absl::btree_map"));
+        REQUIRE(impl_matches("phmap_*", "phmap_parallel", "phmap::parallel_flat_hash_map"));
+        REQUIRE(impl_matches("clht_lb", "CLHT_LB", "CLHT-LB"));
+        REQUIRE_FALSE(impl_matches("std_map", "std_unordered_map", "std::unordered_map"));
+        REQUIRE_FALSE(impl_matches("", "std_map", "std::map"));
+    }
+    
+    SECTION("extended entries need -a unless named") {
+        std::vector<std::string> defaults;
+        std::vector<std::string> named;
+        for_each_impl(kImplementations, [&](const auto& entry) {
+            if (impl_selected(entry, "", false)) {
+                defaults.push_back(entry.name);
+            }
+            if (impl_selected(entry, "OPIC", false)) {
+                named.push_back(entry.name);
+            }
+        });
+        REQUIRE(std::find(defaults.begin(), defaults.end(), "OPIC") == defaults.end());
+        REQUIRE(std::find(defaults.begin(), defaults.end(), "std_unordered_map") != defaults.end());
+        REQUIRE(named == std::vector<std::string>{"OPIC"});
+    }
+    
+    SECTION("comments") {
+        auto entry = std::get<0>(kImplementations);
+        REQUIRE(impl_comment(entry, "int64") == "KV: int64/uintptr_t");
+        REQUIRE(impl_comment(std::get<10>(kImplementations), "int64") == "✅ Lock-Based, KV: int64/uintptr_t");
+    }
+}